@@ -31,6 +31,7 @@ module.exports = {
             '/qtpromise/qtconcurrent',
             '/qtpromise/qtsignals',
             '/qtpromise/thread-safety',
+            '/qtpromise/timers',
             {
                 title: 'API Reference',
                 path: '/qtpromise/api-reference',
@@ -50,11 +51,14 @@ module.exports = {
                             '/qtpromise/qpromise/ispending',
                             '/qtpromise/qpromise/isrejected',
                             '/qtpromise/qpromise/map',
+                            '/qtpromise/qpromise/progress',
                             '/qtpromise/qpromise/reduce',
                             '/qtpromise/qpromise/tap',
                             '/qtpromise/qpromise/tapfail',
                             '/qtpromise/qpromise/then',
                             '/qtpromise/qpromise/timeout',
+                            '/qtpromise/qpromise/tofuture',
+                            '/qtpromise/qpromise/via',
                             '/qtpromise/qpromise/wait',
                             '/qtpromise/qpromise/reject',
                             '/qtpromise/qpromise/resolve'
@@ -64,21 +68,43 @@ module.exports = {
                         title: 'Helpers',
                         children: [
                             '/qtpromise/helpers/all',
+                            '/qtpromise/helpers/allsettled',
+                            '/qtpromise/helpers/any',
+                            '/qtpromise/helpers/ascompleted',
                             '/qtpromise/helpers/attempt',
+                            '/qtpromise/helpers/collect',
                             '/qtpromise/helpers/connect',
+                            '/qtpromise/helpers/debounce',
+                            '/qtpromise/helpers/dispatchmode',
                             '/qtpromise/helpers/each',
+                            '/qtpromise/helpers/eachresult',
+                            '/qtpromise/helpers/every',
+                            '/qtpromise/helpers/everymatch',
                             '/qtpromise/helpers/filter',
+                            '/qtpromise/helpers/find',
+                            '/qtpromise/helpers/findindex',
+                            '/qtpromise/helpers/hedge',
+                            '/qtpromise/helpers/latest',
+                            '/qtpromise/helpers/listen',
                             '/qtpromise/helpers/map',
+                            '/qtpromise/helpers/race',
                             '/qtpromise/helpers/reduce',
-                            '/qtpromise/helpers/resolve'
+                            '/qtpromise/helpers/resolve',
+                            '/qtpromise/helpers/run',
+                            '/qtpromise/helpers/runpending',
+                            '/qtpromise/helpers/some',
+                            '/qtpromise/helpers/somematch',
+                            '/qtpromise/helpers/throttle'
                         ]
                     },
                     {
                         title: 'Exceptions',
                         children: [
+                            '/qtpromise/exceptions/aggregate',
                             '/qtpromise/exceptions/canceled',
                             '/qtpromise/exceptions/context',
                             '/qtpromise/exceptions/conversion',
+                            '/qtpromise/exceptions/superseded',
                             '/qtpromise/exceptions/timeout',
                             '/qtpromise/exceptions/undefined'
                         ]
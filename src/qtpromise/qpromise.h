@@ -9,11 +9,13 @@
 #define QTPROMISE_QPROMISE_H
 
 #include "qpromiseexceptions.h"
+#include "qpromiseexecutor.h"
 #include "qpromise_p.h"
 #include "qpromiseglobal.h"
 #include "qpromiseresolver.h"
 
 #include <QtCore/QExplicitlySharedDataPointer>
+#include <QtCore/QFuture>
 
 #include <chrono>
 
@@ -30,7 +32,13 @@ public:
     inline QPromiseBase(F resolver);
 
     template<typename F,
-             typename std::enable_if<QtPromisePrivate::ArgsOf<F>::count != 1, int>::type = 0>
+             typename std::enable_if<QtPromisePrivate::ArgsOf<F>::count != 1
+                                         && QtPromisePrivate::ArgsOf<F>::count != 3,
+                                     int>::type = 0>
+    inline QPromiseBase(F resolver);
+
+    template<typename F,
+             typename std::enable_if<QtPromisePrivate::ArgsOf<F>::count == 3, int>::type = 0>
     inline QPromiseBase(F resolver);
 
     QPromiseBase(const QPromiseBase<T>& other) : m_d{other.m_d} { }
@@ -67,6 +75,31 @@ public:
     inline typename QtPromisePrivate::PromiseHandler<T, TFulfilled>::Promise
     then(TFulfilled&& fulfilled) const;
 
+    template<typename TFulfilled, typename TRejected>
+    inline typename QtPromisePrivate::PromiseHandler<T, TFulfilled>::Promise
+    then(const QPromiseExecutor& executor,
+         const TFulfilled& fulfilled,
+         const TRejected& rejected) const;
+
+    template<typename TFulfilled>
+    inline typename QtPromisePrivate::PromiseHandler<T, TFulfilled>::Promise
+    then(const QPromiseExecutor& executor, const TFulfilled& fulfilled) const;
+
+    template<typename TContext,
+             typename TFulfilled,
+             typename TRejected,
+             typename std::enable_if<std::is_base_of<QObject, TContext>::value, int>::type = 0>
+    inline typename QtPromisePrivate::PromiseHandler<T, TFulfilled>::Promise
+    then(const TContext* context, const TFulfilled& fulfilled, const TRejected& rejected) const;
+
+    template<typename TContext,
+             typename TFulfilled,
+             typename std::enable_if<std::is_base_of<QObject, TContext>::value, int>::type = 0>
+    inline typename QtPromisePrivate::PromiseHandler<T, TFulfilled>::Promise
+    then(const TContext* context, const TFulfilled& fulfilled) const;
+
+    inline QPromise<T> via(const QPromiseExecutor& executor) const;
+
     template<typename TRejected>
     inline typename QtPromisePrivate::PromiseHandler<T, std::nullptr_t>::Promise
     fail(TRejected&& rejected) const;
@@ -80,6 +113,12 @@ public:
     template<typename THandler>
     inline QPromise<T> tapFail(THandler handler) const;
 
+    template<typename THandler>
+    inline QPromise<T> progress(THandler handler, int msec = 0) const;
+
+    template<typename THandler>
+    inline QPromise<T> progress(THandler handler, std::chrono::milliseconds msec) const;
+
     template<typename E = QPromiseTimeoutException>
     inline QPromise<T> timeout(int msec, E&& error = E{}) const;
 
@@ -90,6 +129,11 @@ public:
     inline QPromise<T> delay(std::chrono::milliseconds msec) const;
 
     inline QPromise<T> wait() const;
+    inline WaitStatus wait(std::chrono::steady_clock::time_point deadline) const;
+    inline WaitStatus waitFor(int msec) const;
+    inline WaitStatus waitFor(std::chrono::milliseconds msec) const;
+
+    inline QFuture<T> toFuture() const;
 
 public: // STATIC
     template<typename E>
@@ -115,13 +159,14 @@ public:
     inline QPromise<U> convert() const;
 
     template<typename Functor>
-    inline QPromise<T> each(Functor fn);
+    inline QPromise<T> each(Functor fn, FailurePolicy policy = FailurePolicy::Continue);
 
     template<typename Functor>
-    inline QPromise<T> filter(Functor fn);
+    inline QPromise<T> filter(Functor fn, FailurePolicy policy = FailurePolicy::Continue);
 
     template<typename Functor>
-    inline typename QtPromisePrivate::PromiseMapper<T, Functor>::PromiseType map(Functor fn);
+    inline typename QtPromisePrivate::PromiseMapper<T, Functor>::PromiseType
+    map(Functor fn, FailurePolicy policy = FailurePolicy::Continue);
 
     template<typename Functor, typename Input>
     inline typename QtPromisePrivate::PromiseDeduce<Input>::Type reduce(Functor fn, Input initial);
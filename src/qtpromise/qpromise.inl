@@ -6,11 +6,13 @@
  */
 
 #include "qpromise.h"
+#include "qpromisefuture.h"
 #include "qpromisehelpers.h"
+#include "qpromiseprogress_p.h"
+#include "qpromisetimer_p.h"
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QSharedPointer>
-#include <QtCore/QTimer>
 
 namespace QtPromise {
 
@@ -28,15 +30,18 @@ inline QPromiseBase<T>::QPromiseBase(F callback) : m_d{new QtPromisePrivate::Pro
 }
 
 template<typename T>
-template<typename F, typename std::enable_if<QtPromisePrivate::ArgsOf<F>::count != 1, int>::type>
+template<typename F,
+         typename std::enable_if<QtPromisePrivate::ArgsOf<F>::count != 1
+                                     && QtPromisePrivate::ArgsOf<F>::count != 3,
+                                 int>::type>
 inline QPromiseBase<T>::QPromiseBase(F callback) : m_d{new QtPromisePrivate::PromiseData<T>{}}
 {
     // To prevent infinite recursion at runtime when resolving the QPromise template
     // constructor, we don't explicitly check for ArgsOf<F>::count == 2 so that this
-    // method is called for ALL callbacks other than the ones with a single typed
-    // argument. This includes valid callbacks such as with two args, variadic or
-    // auto args (c++14) but also invalid callbacks which are not functions or with
-    // 0 or more than 2 arguments, in which case this method MUST fail to compile.
+    // method is called for ALL callbacks other than the ones with a single or three
+    // typed arguments. This includes valid callbacks such as with two args, variadic
+    // or auto args (c++14) but also invalid callbacks which are not functions or with
+    // 0 or more than 3 arguments, in which case this method MUST fail to compile.
 
     QtPromisePrivate::PromiseResolver<T> resolver{*this};
 
@@ -47,6 +52,21 @@ inline QPromiseBase<T>::QPromiseBase(F callback) : m_d{new QtPromisePrivate::Pro
     }
 }
 
+template<typename T>
+template<typename F, typename std::enable_if<QtPromisePrivate::ArgsOf<F>::count == 3, int>::type>
+inline QPromiseBase<T>::QPromiseBase(F callback) : m_d{new QtPromisePrivate::PromiseData<T>{}}
+{
+    QtPromisePrivate::PromiseResolver<T> resolver{*this};
+
+    try {
+        callback(QPromiseResolve<T>(resolver),
+                 QPromiseReject<T>(resolver),
+                 QPromiseProgress<T>(resolver));
+    } catch (...) {
+        resolver.reject(std::current_exception());
+    }
+}
+
 template<typename T>
 template<typename TFulfilled, typename TRejected>
 inline typename QtPromisePrivate::PromiseHandler<T, TFulfilled>::Promise
@@ -57,8 +77,19 @@ QPromiseBase<T>::then(const TFulfilled& fulfilled, const TRejected& rejected) co
 
     PromiseType next([&](const QPromiseResolve<typename PromiseType::Type>& resolve,
                          const QPromiseReject<typename PromiseType::Type>& reject) {
-        m_d->addHandler(PromiseHandler<T, TFulfilled>::create(fulfilled, resolve, reject));
-        m_d->addCatcher(PromiseCatcher<T, TRejected>::create(rejected, resolve, reject));
+        // Only needed if the callbacks are called through an executor (see QPromise::via).
+        std::function<void()> canceled;
+        if (m_d->hasExecutor()) {
+            canceled = [=]() {
+                reject(QPromiseCanceledException{});
+            };
+        }
+
+        m_d->addCallbacks(PromiseHandler<T, TFulfilled>::create(fulfilled, resolve, reject),
+                          PromiseCatcher<T, TRejected>::create(rejected, resolve, reject),
+                          nullptr,
+                          nullptr,
+                          std::move(canceled));
     });
 
     if (!m_d->isPending()) {
@@ -76,6 +107,102 @@ QPromiseBase<T>::then(TFulfilled&& fulfilled) const
     return then(std::forward<TFulfilled>(fulfilled), nullptr);
 }
 
+template<typename T>
+template<typename TFulfilled, typename TRejected>
+inline typename QtPromisePrivate::PromiseHandler<T, TFulfilled>::Promise
+QPromiseBase<T>::then(const QPromiseExecutor& executor,
+                      const TFulfilled& fulfilled,
+                      const TRejected& rejected) const
+{
+    using namespace QtPromisePrivate;
+    using PromiseType = typename PromiseHandler<T, TFulfilled>::Promise;
+
+    PromiseType next([&](const QPromiseResolve<typename PromiseType::Type>& resolve,
+                         const QPromiseReject<typename PromiseType::Type>& reject) {
+        // The output is rejected if `executor` drops the callback (see PromiseCallback).
+        auto canceled = [=]() {
+            reject(QPromiseCanceledException{});
+        };
+
+        m_d->addCallbacks(PromiseHandler<T, TFulfilled>::create(fulfilled, resolve, reject),
+                          PromiseCatcher<T, TRejected>::create(rejected, resolve, reject),
+                          nullptr,
+                          executor.m_d,
+                          canceled);
+    });
+
+    if (!m_d->isPending()) {
+        m_d->dispatch();
+    }
+
+    return next;
+}
+
+template<typename T>
+template<typename TFulfilled>
+inline typename QtPromisePrivate::PromiseHandler<T, TFulfilled>::Promise
+QPromiseBase<T>::then(const QPromiseExecutor& executor, const TFulfilled& fulfilled) const
+{
+    return then(executor, fulfilled, nullptr);
+}
+
+template<typename T>
+template<typename TContext,
+         typename TFulfilled,
+         typename TRejected,
+         typename std::enable_if<std::is_base_of<QObject, TContext>::value, int>::type>
+inline typename QtPromisePrivate::PromiseHandler<T, TFulfilled>::Promise
+QPromiseBase<T>::then(const TContext* context,
+                      const TFulfilled& fulfilled,
+                      const TRejected& rejected) const
+{
+    using namespace QtPromisePrivate;
+    using PromiseType = typename PromiseHandler<T, TFulfilled>::Promise;
+
+    // The callbacks are called in the thread of `context` (see PromiseContextExecutor) and
+    // detached from this promise if `context` is destroyed before (see PromiseContextLink).
+    PromiseExecutorPtr executor = std::make_shared<PromiseContextExecutor>(context);
+    auto link = std::make_shared<PromiseContextLink>();
+
+    PromiseType next([&](const QPromiseResolve<typename PromiseType::Type>& resolve,
+                         const QPromiseReject<typename PromiseType::Type>& reject) {
+        auto handler = PromiseHandler<T, TFulfilled>::create(fulfilled, resolve, reject);
+        auto catcher = PromiseCatcher<T, TRejected>::create(rejected, resolve, reject);
+        m_d->addCallbacks(link->wrap(std::move(handler)),
+                          link->wrap(std::move(catcher)),
+                          link.get(),
+                          executor);
+    });
+
+    link->connect(context, m_d);
+
+    if (!m_d->isPending()) {
+        m_d->dispatch();
+    }
+
+    return next;
+}
+
+template<typename T>
+template<typename TContext,
+         typename TFulfilled,
+         typename std::enable_if<std::is_base_of<QObject, TContext>::value, int>::type>
+inline typename QtPromisePrivate::PromiseHandler<T, TFulfilled>::Promise
+QPromiseBase<T>::then(const TContext* context, const TFulfilled& fulfilled) const
+{
+    return then(context, fulfilled, nullptr);
+}
+
+template<typename T>
+inline QPromise<T> QPromiseBase<T>::via(const QPromiseExecutor& executor) const
+{
+    // The value is forwarded as soon as settled, then the callbacks registered on the
+    // returned promise are called through `executor` unless given another executor.
+    QPromise<T> next = then(QPromiseExecutor::immediate(), nullptr, nullptr);
+    next.m_d->setExecutor(executor.m_d);
+    return next;
+}
+
 template<typename T>
 template<typename TRejected>
 inline typename QtPromisePrivate::PromiseHandler<T, std::nullptr_t>::Promise
@@ -114,20 +241,31 @@ inline QPromise<T> QPromiseBase<T>::tapFail(THandler handler) const
     });
 }
 
+template<typename T>
+template<typename THandler>
+inline QPromise<T> QPromiseBase<T>::progress(THandler handler, int msec) const
+{
+    QtPromisePrivate::PromiseProgress listener{std::move(handler), msec};
+    m_d->addProgress({listener, [=]() {
+                          listener.close();
+                      }});
+    return *this;
+}
+
+template<typename T>
+template<typename THandler>
+inline QPromise<T> QPromiseBase<T>::progress(THandler handler, std::chrono::milliseconds msec) const
+{
+    return progress(std::move(handler), static_cast<int>(msec.count()));
+}
+
 template<typename T>
 template<typename E>
 inline QPromise<T> QPromiseBase<T>::timeout(int msec, E&& error) const
 {
     QPromise<T> p = *this;
     return QPromise<T>{[&](const QPromiseResolve<T>& resolve, const QPromiseReject<T>& reject) {
-        QTimer::singleShot(msec, [=]() {
-            // we don't need to verify the current promise state, reject()
-            // takes care of checking if the promise is already resolved,
-            // and thus will ignore this rejection.
-            reject(std::move(error));
-        });
-
-        QtPromisePrivate::PromiseFulfill<QPromise<T>>::call(p, resolve, reject);
+        QtPromisePrivate::PromiseTimeout<T>::call(p, msec, std::forward<E>(error), resolve, reject);
     }};
 }
 
@@ -141,11 +279,10 @@ inline QPromise<T> QPromiseBase<T>::timeout(std::chrono::milliseconds msec, E&&
 template<typename T>
 inline QPromise<T> QPromiseBase<T>::delay(int msec) const
 {
-    return tap([=]() {
-        return QPromise<void>{[&](const QPromiseResolve<void>& resolve) {
-            QTimer::singleShot(msec, resolve);
-        }};
-    });
+    QPromise<T> p = *this;
+    return QPromise<T>{[&](const QPromiseResolve<T>& resolve, const QPromiseReject<T>& reject) {
+        QtPromisePrivate::PromiseDelay<T>::call(p, msec, resolve, reject);
+    }};
 }
 
 template<typename T>
@@ -157,13 +294,49 @@ inline QPromise<T> QPromiseBase<T>::delay(std::chrono::milliseconds msec) const
 template<typename T>
 inline QPromise<T> QPromiseBase<T>::wait() const
 {
-    // @TODO wait timeout + global timeout
-    while (m_d->isPending()) {
-        QCoreApplication::processEvents(QEventLoop::AllEvents);
-        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    wait(std::chrono::steady_clock::time_point::max());
+    return *this;
+}
+
+template<typename T>
+inline WaitStatus QPromiseBase<T>::wait(std::chrono::steady_clock::time_point deadline) const
+{
+    QtPromisePrivate::PromiseWait::call(*m_d, deadline);
+
+    if (m_d->isPending()) {
+        return WaitStatus::Timeout;
     }
 
-    return *this;
+    return m_d->isFulfilled() ? WaitStatus::Fulfilled : WaitStatus::Rejected;
+}
+
+template<typename T>
+inline WaitStatus QPromiseBase<T>::waitFor(int msec) const
+{
+    return waitFor(std::chrono::milliseconds{msec});
+}
+
+template<typename T>
+inline WaitStatus QPromiseBase<T>::waitFor(std::chrono::milliseconds msec) const
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Clamp the deadline instead of overflowing the clock for very long durations.
+    const auto now = Clock::now();
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        Clock::time_point::max() - now);
+
+    if (msec >= remaining) {
+        return wait(Clock::time_point::max());
+    }
+
+    return wait(now + qMax(msec, std::chrono::milliseconds::zero()));
+}
+
+template<typename T>
+inline QFuture<T> QPromiseBase<T>::toFuture() const
+{
+    return QtPromisePrivate::PromiseToFuture<T>::call(m_d);
 }
 
 template<typename T>
@@ -177,41 +350,45 @@ inline QPromise<T> QPromiseBase<T>::reject(E&& error)
 
 template<typename T>
 template<typename Functor>
-inline QPromise<T> QPromise<T>::each(Functor fn)
+inline QPromise<T> QPromise<T>::each(Functor fn, FailurePolicy policy)
 {
+    using namespace QtPromisePrivate;
+    using ResultType = typename PromiseMapper<T, Functor>::ReturnType;
+    using PromiseType = typename PromiseDeduce<ResultType>::Type;
+
     return this->tap([=](const T& values) {
         int i = 0;
 
-        std::vector<QPromise<void>> promises;
+        // The promises returned by fn are used as-is so they can be canceled on failure.
+        std::vector<PromiseType> promises;
         for (const auto& v : values) {
-            promises.push_back(QtPromise::attempt(fn, v, i).then([]() {
-                // Cast to void in case fn returns a non promise value.
-                // TODO remove when implicit cast is implemented.
+            promises.push_back(PromiseInvoke<Unqualified<ResultType>>::call([&]() {
+                return fn(v, i);
             }));
 
             i++;
         }
 
-        return QtPromise::all(promises);
+        return PromiseJoin::call(promises, policy == FailurePolicy::Cancel);
     });
 }
 
 template<typename T>
 template<typename Functor>
-inline QPromise<T> QPromise<T>::filter(Functor fn)
+inline QPromise<T> QPromise<T>::filter(Functor fn, FailurePolicy policy)
 {
     return this->then([=](const T& values) {
-        return QtPromise::filter(values, fn);
+        return QtPromise::filter(values, fn, policy);
     });
 }
 
 template<typename T>
 template<typename Functor>
 inline typename QtPromisePrivate::PromiseMapper<T, Functor>::PromiseType
-QPromise<T>::map(Functor fn)
+QPromise<T>::map(Functor fn, FailurePolicy policy)
 {
     return this->then([=](const T& values) {
-        return QtPromise::map(values, fn);
+        return QtPromise::map(values, fn, policy);
     });
 }
 
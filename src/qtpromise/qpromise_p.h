@@ -12,15 +12,26 @@
 
 #include <QtCore/QAbstractEventDispatcher>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
 #include <QtCore/QPointer>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QSharedData>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QTimer>
 #include <QtCore/QVariant>
 #include <QtCore/QVector>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 
 namespace QtPromise {
 
@@ -35,6 +46,8 @@ class QPromiseReject;
 
 class QPromiseConversionException;
 
+class QPromiseExecutor;
+
 } // namespace QtPromise
 
 namespace QtPromisePrivate {
@@ -47,9 +60,250 @@ template<class F, class... ArgTypes>
 using invoke_result = std::result_of<F(ArgTypes...)>;
 #endif
 
+// Continuations queued for a thread without event loop (e.g. std::thread, QThreadPool worker),
+// or for a thread in manual dispatch mode (see QtPromise::setDispatchMode), see qtpromise_defer.
+// They are called by the thread itself, either while blocked waiting for a promise (see
+// PromiseWait) or when explicitly running them (see QtPromise::runPending).
+class PromiseQueue
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Posted to the event dispatcher of a thread which doesn't run its event loop (see
+    // qtpromise_defer) to run its queue if it runs one later: at most one is pending per
+    // queue (see post()), so the events don't pile up in a thread which never runs one.
+    class RunEvent : public QEvent
+    {
+    public:
+        RunEvent(std::shared_ptr<PromiseQueue> queue, QThread* thread)
+            : QEvent{QEvent::None}, m_queue{std::move(queue)}, m_thread{thread}
+        { }
+
+        // Also deleted without being delivered (e.g. when the thread finishes), in which case
+        // the queue must not be run from another thread.
+        ~RunEvent() override
+        {
+            m_queue->setPosted(false);
+            if (QThread::currentThread() == m_thread) {
+                m_queue->run();
+            }
+        }
+
+    private:
+        std::shared_ptr<PromiseQueue> m_queue;
+        QThread* m_thread;
+    };
+
+    ~PromiseQueue()
+    {
+        if (m_manual) {
+            --manualCount();
+        }
+    }
+
+    // Returns the queue of the given thread, created if needed (else nullptr if none).
+    static std::shared_ptr<PromiseQueue> of(QThread* thread, bool create = true)
+    {
+        struct Entry
+        {
+            QPointer<QThread> thread;
+            std::shared_ptr<PromiseQueue> queue;
+        };
+
+        static QMutex mutex;
+        static QHash<QThread*, Entry> queues;
+
+        QMutexLocker lock{&mutex};
+        auto it = queues.find(thread);
+        if (it != queues.end() && it->thread) {
+            return it->queue;
+        }
+
+        if (!create) {
+            return nullptr;
+        }
+
+        // Release the queues of the destroyed threads (which may also have
+        // been replaced by a new thread allocated at the same address).
+        for (it = queues.begin(); it != queues.end();) {
+            it = it->thread ? std::next(it) : queues.erase(it);
+        }
+
+        auto queue = std::make_shared<PromiseQueue>();
+        queues.insert(thread, {thread, queue});
+        return queue;
+    }
+
+    // Returns true if continuations for the given thread must be queued even if it has an
+    // event loop. Cheap as long as no thread is in manual dispatch mode.
+    static bool isManual(QThread* thread)
+    {
+        if (manualCount() == 0) {
+            return false;
+        }
+
+        auto queue = of(thread, false);
+        return queue && queue->isManual();
+    }
+
+    bool isManual() const { return m_manual; }
+
+    // Returns false if the current thread has an event dispatcher but doesn't run its event
+    // loop (e.g. QThreadPool workers, or a QThread which reimplements run()), in which case the
+    // continuations it registers are also queued (see qtpromise_defer). The main thread is
+    // assumed to run (or to be about to run) the application event loop.
+    static bool hasEventLoop()
+    {
+        QThread* thread = QThread::currentThread();
+        if (thread->loopLevel() > 0) {
+            return true;
+        }
+
+        const QCoreApplication* app = QCoreApplication::instance();
+        return app && app->thread() == thread;
+    }
+
+    void setManual(bool manual)
+    {
+        if (m_manual.exchange(manual) != manual) {
+            manual ? ++manualCount() : --manualCount();
+        }
+    }
+
+    void enqueue(std::function<void()> fn)
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_items.push_back(std::move(fn));
+        }
+
+        m_cond.notify_all();
+    }
+
+    // Returns true if the caller must post a RunEvent to the thread of this queue, i.e. if
+    // none is pending yet.
+    bool post()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        const bool posted = m_posted;
+        m_posted = true;
+        return !posted;
+    }
+
+    void setPosted(bool posted)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_posted = posted;
+    }
+
+    void wakeUp()
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_woken = true;
+        }
+
+        m_cond.notify_all();
+    }
+
+    // Calls `fn` from run() or wait() once `deadline` is reached, replacing the previous
+    // timer (cleared if `fn` is null). Used to drive the timers of a thread without event
+    // dispatcher (see PromiseTimerWheel), thus must be called from the thread of this queue.
+    void setTimer(Clock::time_point deadline, std::function<void()> fn)
+    {
+        m_timerDeadline = fn ? deadline : Clock::time_point::max();
+        m_timer = std::move(fn);
+    }
+
+    // Calls the queued continuations in order, including the ones queued meanwhile, until
+    // the queue is empty, `maxItems` continuations have been called (if positive) or the
+    // `deadline` is reached (checked after each continuation, so at least one is called).
+    // Returns how many continuations have been called (the expired timer not included).
+    int run(int maxItems = -1, Clock::time_point deadline = Clock::time_point::max())
+    {
+        expire();
+
+        int count = 0;
+        while (maxItems < 0 || count < maxItems) {
+            std::function<void()> item;
+            {
+                std::lock_guard<std::mutex> lock{m_mutex};
+                if (m_items.empty()) {
+                    break;
+                }
+
+                item = std::move(m_items.front());
+                m_items.pop_front();
+            }
+
+            item();
+            ++count;
+
+            if (deadline != Clock::time_point::max() && Clock::now() >= deadline) {
+                break;
+            }
+        }
+
+        return count;
+    }
+
+    // Blocks until a continuation is queued, wakeUp() is called or the timer expires, then
+    // calls the queued continuations. Returns false if `deadline` has been reached before.
+    bool wait(Clock::time_point deadline)
+    {
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            const auto until = std::min(deadline, m_timerDeadline);
+            if (!m_cond.wait_until(lock, until, [this]() {
+                    return m_woken || !m_items.empty();
+                })) {
+                if (until == deadline) {
+                    return false;
+                }
+            }
+
+            m_woken = false;
+        }
+
+        run();
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<std::function<void()>> m_items;
+    std::atomic<bool> m_manual{false};
+    bool m_woken = false;
+    bool m_posted = false;
+
+    // Only accessed from the thread of this queue (see setTimer()).
+    Clock::time_point m_timerDeadline = Clock::time_point::max();
+    std::function<void()> m_timer;
+
+    void expire()
+    {
+        if (m_timer && Clock::now() >= m_timerDeadline) {
+            auto timer = std::move(m_timer);
+            m_timer = nullptr;
+            m_timerDeadline = Clock::time_point::max();
+
+            // May set the next timer.
+            timer();
+        }
+    }
+
+    // Number of threads in manual dispatch mode.
+    static std::atomic<int>& manualCount()
+    {
+        static std::atomic<int> count{0};
+        return count;
+    }
+};
+
 // https://stackoverflow.com/a/21653558
 template<typename F>
-static void qtpromise_defer(F&& f, const QPointer<QThread>& thread)
+static void qtpromise_defer(F&& f, const QPointer<QThread>& thread, bool queued = false)
 {
     using FType = typename std::decay<F>::type;
 
@@ -78,7 +332,29 @@ static void qtpromise_defer(F&& f, const QPointer<QThread>& thread)
         return;
     }
 
-    Q_ASSERT_X(target, "postMetaCall", "Target thread must have an event loop");
+    if (!target || PromiseQueue::isManual(thread)) {
+        // The target thread has no event loop or is in manual dispatch mode: `f` will be
+        // called by that thread when waiting for a promise or explicitly running pending
+        // continuations. The event loop (if any) is woken up in case it's blocked in wait().
+        PromiseQueue::of(thread)->enqueue(std::forward<F>(f));
+        if (target) {
+            static_cast<QAbstractEventDispatcher*>(target)->wakeUp();
+        }
+        return;
+    }
+
+    if (queued) {
+        // The target thread didn't run its event loop when `f` has been registered (see
+        // PromiseQueue::hasEventLoop): `f` is only queued as if it had no event loop, and the
+        // queue is also run by the event loop if one runs later (see PromiseQueue::RunEvent).
+        auto queue = PromiseQueue::of(thread);
+        queue->enqueue(std::forward<F>(f));
+        if (queue->post()) {
+            QCoreApplication::postEvent(target, new PromiseQueue::RunEvent{queue, thread});
+        }
+        return;
+    }
+
     QCoreApplication::postEvent(target, new Event{std::forward<F>(f)});
 }
 
@@ -241,7 +517,25 @@ struct PromiseDispatch<void>
     }
 };
 
-template<typename T, typename THandler, typename TArg = typename ArgsOf<THandler>::first>
+struct PromiseContextArg
+{ };
+
+// First argument of `THandler`, except for a pointer to a QObject, which is not a handler but the
+// context given to QPromise::then(context, handler) (see PromiseHandler<T, C, PromiseContextArg>).
+template<typename THandler, typename Enabled = void>
+struct PromiseHandlerArg
+{
+    using Type = typename ArgsOf<THandler>::first;
+};
+
+template<typename THandler>
+struct PromiseHandlerArg<THandler*,
+                         typename std::enable_if<std::is_base_of<QObject, THandler>::value>::type>
+{
+    using Type = PromiseContextArg;
+};
+
+template<typename T, typename THandler, typename TArg = typename PromiseHandlerArg<THandler>::Type>
 struct PromiseHandler
 {
     using ResType = typename invoke_result<THandler, T>::type;
@@ -322,6 +616,21 @@ struct PromiseHandler<void, std::nullptr_t, void>
     }
 };
 
+// Not a handler: prevents QPromise::then(executor, handler) from also matching (and failing to
+// instantiate) QPromise::then(fulfilled, rejected), which return type is then ill-formed.
+template<typename T>
+struct PromiseHandler<T, QtPromise::QPromiseExecutor, void>
+{ };
+
+template<>
+struct PromiseHandler<void, QtPromise::QPromiseExecutor, void>
+{ };
+
+// Not a handler: same for QPromise::then(context, handler), with any QObject subclass.
+template<typename T, typename THandler>
+struct PromiseHandler<T, THandler, PromiseContextArg>
+{ };
+
 template<typename T, typename THandler, typename TArg = typename ArgsOf<THandler>::first>
 struct PromiseCatcher
 {
@@ -392,12 +701,104 @@ struct PromiseMapper<Sequence<T, Args...>, F>
 template<typename T>
 class PromiseData;
 
+// Schedules the callbacks registered with an explicit executor (see QtPromise::QPromiseExecutor)
+// instead of deferring them to the thread which registered them.
+class PromiseExecutor
+{
+public:
+    virtual ~PromiseExecutor() { }
+
+    // Returns false if `fn` will never be called (e.g. the thread pool has been destroyed).
+    virtual bool execute(std::function<void()> fn) const = 0;
+};
+
+using PromiseExecutorPtr = std::shared_ptr<const PromiseExecutor>;
+
+// Enqueues the callbacks to the queue of a thread which runs it itself (e.g. a pool worker),
+// installed as the default executor of the callbacks registered from that thread so that they
+// are queued directly, without looking up the queue of their thread (see qtpromise_defer).
+class PromiseQueueExecutor : public PromiseExecutor
+{
+public:
+    explicit PromiseQueueExecutor(std::shared_ptr<PromiseQueue> queue) : m_queue{std::move(queue)}
+    { }
+
+    bool execute(std::function<void()> fn) const Q_DECL_OVERRIDE
+    {
+        m_queue->enqueue(std::move(fn));
+        return true;
+    }
+
+    // Returns the executor installed for the current thread, if any.
+    static PromiseExecutorPtr current()
+    {
+        auto& storage = threadStorage();
+        return storage.hasLocalData() ? storage.localData() : nullptr;
+    }
+
+    static void setCurrent(PromiseExecutorPtr executor)
+    {
+        threadStorage().setLocalData(std::move(executor));
+    }
+
+private:
+    std::shared_ptr<PromiseQueue> m_queue;
+
+    static QThreadStorage<PromiseExecutorPtr>& threadStorage()
+    {
+        static QThreadStorage<PromiseExecutorPtr> storage;
+        return storage;
+    }
+};
+
+template<typename F>
+struct PromiseCallback
+{
+    QPointer<QThread> thread;
+    std::function<F> fn;
+
+    // Opaque key identifying who registered this callback (e.g. a combinator)
+    // in order to be able to detach it before the promise is settled.
+    const void* owner;
+
+    // If not null, `fn` is called through this executor instead of `thread`.
+    PromiseExecutorPtr executor;
+
+    // True if `thread` didn't run its event loop when registering this callback.
+    bool queued;
+
+    // If not null, called (from the settling thread) instead of `fn` if `executor` drops it,
+    // e.g. to reject the output promise with QPromiseCanceledException.
+    std::function<void()> canceled;
+
+    template<typename C>
+    void post(C&& call) const
+    {
+        if (executor) {
+            if (!executor->execute(std::forward<C>(call)) && canceled) {
+                canceled();
+            }
+        } else {
+            qtpromise_defer(std::forward<C>(call), thread, queued);
+        }
+    }
+};
+
 template<typename T, typename F>
 class PromiseDataBase : public QSharedData
 {
 public:
-    using Handler = std::pair<QPointer<QThread>, std::function<F>>;
-    using Catcher = std::pair<QPointer<QThread>, std::function<void(const PromiseError&)>>;
+    using Handler = PromiseCallback<F>;
+    using Catcher = PromiseCallback<void(const PromiseError&)>;
+    using Waiter = PromiseCallback<void()>;
+
+    // Progress listener (see PromiseProgress): `report` is called each time progress is
+    // reported, then `close` once the promise is settled (before notifying the handlers).
+    struct Progress
+    {
+        std::function<void(int, int)> report;
+        std::function<void()> close;
+    };
 
     virtual ~PromiseDataBase() { }
 
@@ -410,16 +811,135 @@ public:
         return !m_settled;
     }
 
-    void addHandler(std::function<F> handler)
+    // Registers the `handler` and `catcher` of a continuation, only one of them being called.
+    void addCallbacks(std::function<F> handler,
+                      std::function<void(const PromiseError&)> catcher,
+                      const void* owner = nullptr,
+                      PromiseExecutorPtr executor = nullptr,
+                      std::function<void()> canceled = nullptr)
     {
+        QThread* thread = QThread::currentThread();
+        const bool queued = !PromiseQueue::hasEventLoop();
+
         QWriteLocker lock{&m_lock};
-        m_handlers.append({QThread::currentThread(), std::move(handler)});
+        executor = executorFor(std::move(executor));
+        m_handlers.append({thread, std::move(handler), owner, executor, queued, canceled});
+        m_catchers.append(
+            {thread, std::move(catcher), owner, std::move(executor), queued, std::move(canceled)});
+    }
+
+    bool hasExecutor() const
+    {
+        QReadLocker lock{&m_lock};
+        return m_executor != nullptr;
+    }
+
+    // Sets the executor of the callbacks registered without explicit executor (see
+    // QPromise::via), which must be done before registering any callback.
+    void setExecutor(PromiseExecutorPtr executor)
+    {
+        QWriteLocker lock{&m_lock};
+        m_executor = std::move(executor);
+    }
+
+    // Registers `waiter` to be called synchronously, from the settling thread, as soon
+    // as the promise is settled. Returns false, without registering it, if the promise
+    // has already been settled.
+    bool addWaiter(std::function<void()> waiter, const void* owner)
+    {
+        QWriteLocker lock{&m_lock};
+        if (m_settled) {
+            return false;
+        }
+
+        m_waiters.append(
+            {QThread::currentThread(), std::move(waiter), owner, nullptr, false, nullptr});
+        return true;
+    }
+
+    void removeWaiter(const void* owner)
+    {
+        QWriteLocker lock{&m_lock};
+        removeCallbacks(m_waiters, owner);
+    }
+
+    // Registers `listener` to be called synchronously, from the reporting thread, each time
+    // progress is reported until the promise is settled (see PromiseProgress). The first
+    // listener starts the progress source, if any (e.g. observing a QFuture progress).
+    void addProgress(Progress listener)
+    {
+        std::function<void()> source;
+
+        m_lock.lockForWrite();
+        if (!m_settled) {
+            m_progress.append(std::move(listener));
+            source = std::move(m_progressSource);
+            m_progressSource = nullptr;
+        }
+        m_lock.unlock();
+
+        if (source) {
+            source();
+        }
+    }
+
+    // Registers `source` to be called when the first progress listener is added, so that
+    // progress is only observed when somebody is interested in it.
+    void setProgressSource(std::function<void()> source)
+    {
+        m_lock.lockForWrite();
+        const bool start = !m_settled && !m_progress.isEmpty();
+        if (!m_settled && !start) {
+            m_progressSource = std::move(source);
+        }
+        m_lock.unlock();
+
+        if (start) {
+            source();
+        }
     }
 
-    void addCatcher(std::function<void(const PromiseError&)> catcher)
+    void progress(int value, int maximum) const
+    {
+        m_lock.lockForRead();
+        const QVector<Progress> listeners = m_progress;
+        m_lock.unlock();
+
+        for (const auto& listener : listeners) {
+            listener.report(value, maximum);
+        }
+    }
+
+    void addCanceler(std::function<void()> canceler)
     {
         QWriteLocker lock{&m_lock};
-        m_catchers.append({QThread::currentThread(), std::move(catcher)});
+        if (!m_settled) {
+            m_cancelers.append(std::move(canceler));
+        }
+    }
+
+    // Removes the handlers and catchers registered by `owner` so they will never be
+    // called. If `cancel` is true, the promise is still pending and nobody else is
+    // observing it, the work producing its value is not needed anymore, so let's ask
+    // the source to stop it (only applies to sources supporting cancelation, e.g. QFuture).
+    void detach(const void* owner, bool cancel = true)
+    {
+        Q_ASSERT(owner);
+
+        m_lock.lockForWrite();
+        removeCallbacks(m_handlers, owner);
+        removeCallbacks(m_catchers, owner);
+
+        QVector<std::function<void()>> cancelers;
+        if (cancel && !m_settled && m_handlers.isEmpty() && m_catchers.isEmpty()) {
+            cancelers = std::move(m_cancelers);
+            m_cancelers.clear();
+        }
+        m_lock.unlock();
+
+        for (const auto& canceler : cancelers) {
+            canceler();
+        }
     }
 
     template<typename E>
@@ -453,23 +973,37 @@ public:
         m_lock.lockForWrite();
         QVector<Handler> handlers = std::move(m_handlers);
         QVector<Catcher> catchers = std::move(m_catchers);
+        QVector<Waiter> waiters = std::move(m_waiters);
+        // Progress listeners and source are released (outside the lock) once settled.
+        QVector<Progress> listeners = std::move(m_progress);
+        std::function<void()> source = std::move(m_progressSource);
+        m_progressSource = nullptr;
+        m_cancelers.clear();
         m_lock.unlock();
 
-        if (m_error.isNull()) {
-            notify(handlers);
-            return;
+        // Progress updates not delivered yet must not be delivered after the handlers.
+        for (const auto& listener : listeners) {
+            listener.close();
         }
 
-        PromiseError error = m_error;
-        Q_ASSERT(!error.isNull());
+        if (m_error.isNull()) {
+            notify(handlers);
+        } else {
+            PromiseError error = m_error;
+            Q_ASSERT(!error.isNull());
 
-        for (const auto& catcher : catchers) {
-            const auto& fn = catcher.second;
-            qtpromise_defer(
-                [=]() {
+            for (const auto& catcher : catchers) {
+                const auto& fn = catcher.fn;
+                catcher.post([=]() {
                     fn(error);
-                },
-                catcher.first);
+                });
+            }
+        }
+
+        // Waiters are notified last so that continuations are already queued
+        // when the waiting threads wake up.
+        for (const auto& waiter : waiters) {
+            waiter.fn();
         }
     }
 
@@ -485,11 +1019,38 @@ protected:
 
     virtual void notify(const QVector<Handler>&) = 0;
 
+    // Executor of a callback registered from the current thread (with the lock held): the given
+    // one, else the one set with setExecutor(), else the one of the thread (if any).
+    PromiseExecutorPtr executorFor(PromiseExecutorPtr executor) const
+    {
+        if (executor) {
+            return executor;
+        }
+
+        return m_executor ? m_executor : PromiseQueueExecutor::current();
+    }
+
 private:
     bool m_settled = false;
     QVector<Handler> m_handlers;
     QVector<Catcher> m_catchers;
+    QVector<Waiter> m_waiters;
+    QVector<Progress> m_progress;
+    std::function<void()> m_progressSource;
+    QVector<std::function<void()>> m_cancelers;
+    PromiseExecutorPtr m_executor;
     PromiseError m_error;
+
+    template<typename C>
+    static void removeCallbacks(QVector<C>& callbacks, const void* owner)
+    {
+        callbacks.erase(std::remove_if(callbacks.begin(),
+                                       callbacks.end(),
+                                       [=](const C& callback) {
+                                           return callback.owner == owner;
+                                       }),
+                        callbacks.end());
+    }
 };
 
 template<typename T>
@@ -519,12 +1080,10 @@ public:
         Q_ASSERT(!value.isNull());
 
         for (const auto& handler : handlers) {
-            const auto& fn = handler.second;
-            qtpromise_defer(
-                [=]() {
-                    fn(value.data());
-                },
-                handler.first);
+            const auto& fn = handler.fn;
+            handler.post([=]() {
+                fn(value.data());
+            });
         }
     }
 
@@ -544,11 +1103,122 @@ protected:
     void notify(const QVector<Handler>& handlers) Q_DECL_OVERRIDE
     {
         for (const auto& handler : handlers) {
-            qtpromise_defer(handler.second, handler.first);
+            handler.post(handler.fn);
+        }
+    }
+};
+
+// Blocks the current thread until `data` is settled or `deadline` is reached. If the thread
+// has an event loop, its events are processed while waiting since the promise may depend on
+// them (e.g. continuations, timers or signals), but the thread sleeps while idle instead of
+// spinning and is woken up as soon as the promise is settled, possibly from another thread.
+// Else, the thread blocks on its continuation queue (see PromiseQueue), calling the queued
+// continuations until the promise settles.
+struct PromiseWait
+{
+    using Clock = std::chrono::steady_clock;
+
+    template<typename T, typename F>
+    static void call(PromiseDataBase<T, F>& data, Clock::time_point deadline)
+    {
+        if (!data.isPending()) {
+            return;
+        }
+
+        auto state = std::make_shared<State>();
+        state->dispatcher = QAbstractEventDispatcher::instance();
+        if (!state->dispatcher) {
+            state->queue = PromiseQueue::of(QThread::currentThread());
+        }
+
+        // In manual dispatch mode, the continuations the promise may depend on are queued.
+        std::shared_ptr<PromiseQueue> pending;
+        if (state->dispatcher && PromiseQueue::isManual(QThread::currentThread())) {
+            pending = PromiseQueue::of(QThread::currentThread());
+        }
+
+        if (!data.addWaiter(
+                [=]() {
+                    state->notify();
+                },
+                state.get())) {
+            return;
+        }
+
+        if (state->dispatcher) {
+            process(data, deadline, pending.get());
+        } else {
+            // Continuations queued before the wait may settle the promise.
+            state->queue->run();
+            while (data.isPending() && state->queue->wait(deadline)) { }
+        }
+
+        data.removeWaiter(state.get());
+        state->release();
+    }
+
+private:
+    struct State
+    {
+        std::mutex mutex;
+        std::shared_ptr<PromiseQueue> queue;
+        QAbstractEventDispatcher* dispatcher = nullptr;
+
+        void notify()
+        {
+            // The dispatcher is accessed under lock since it may be released (see
+            // release()) from the waiting thread as soon as it stops waiting.
+            std::lock_guard<std::mutex> lock{mutex};
+            if (dispatcher) {
+                dispatcher->wakeUp();
+            }
+            if (queue) {
+                queue->wakeUp();
+            }
+        }
+
+        void release()
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            dispatcher = nullptr;
+        }
+    };
+
+    template<typename T, typename F>
+    static void
+    process(PromiseDataBase<T, F>& data, Clock::time_point deadline, PromiseQueue* pending)
+    {
+        // Wakes up the event loop when the deadline is reached.
+        QTimer timer;
+        timer.setSingleShot(true);
+
+        while (data.isPending()) {
+            if (pending && pending->run() > 0) {
+                continue;
+            }
+
+            if (deadline != Clock::time_point::max() && !timer.isActive()) {
+                const auto now = Clock::now();
+                if (now >= deadline) {
+                    break;
+                }
+
+                // Rounded up to make sure that the deadline is reached when the timer expires.
+                using namespace std::chrono;
+                const auto msec = duration_cast<milliseconds>(deadline - now).count() + 1;
+                timer.start(static_cast<int>(qMin(static_cast<qint64>(msec), qint64(INT_MAX))));
+            }
+
+            QCoreApplication::processEvents(QEventLoop::AllEvents
+                                            | QEventLoop::WaitForMoreEvents);
+            QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
         }
     }
 };
 
+template<typename T>
+class PromiseResolver;
+
 struct PromiseInspect
 {
     template<typename T>
@@ -556,6 +1226,18 @@ struct PromiseInspect
     {
         return p.m_d.data();
     }
+
+    template<typename T>
+    static inline PromiseResolver<T>& resolver(const QtPromise::QPromiseResolve<T>& resolve)
+    {
+        return resolve.m_resolver;
+    }
+
+    template<typename T>
+    static inline PromiseResolver<T>& resolver(const QtPromise::QPromiseReject<T>& reject)
+    {
+        return reject.m_resolver;
+    }
 };
 
 template<typename T, typename U, bool IsConvertibleViaStaticCast>
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef QTPROMISE_QPROMISECLOCK_H
+#define QTPROMISE_QPROMISECLOCK_H
+
+#include <QtCore/QtGlobal>
+
+#include <chrono>
+
+namespace QtPromise {
+
+// Source of time of the promise timers (e.g. QPromise::timeout, QPromise::delay) of a
+// thread. The default (system) clock relies on a monotonic clock and on a Qt timer.
+class QPromiseClock
+{
+public:
+    virtual ~QPromiseClock() { }
+
+    // Current time in milliseconds, must be monotonic.
+    virtual qint64 now() const = 0;
+
+    // Requests a call to expire() once now() reaches `deadline`, replacing any previous
+    // request. A negative `deadline` means that there is no more timer to expire.
+    virtual void schedule(qint64 deadline) = 0;
+
+    static QPromiseClock* current();
+    static void install(QPromiseClock* clock);
+
+protected:
+    static void expire();
+};
+
+// Clock whose time only moves when advance() is called, in which case the expired timers
+// are triggered synchronously, in order. It's installed on the current thread during its
+// lifetime and is meant to test timer-based code (e.g. QPromise::timeout) deterministically.
+class QPromiseVirtualClock : public QPromiseClock
+{
+public:
+    QPromiseVirtualClock() : m_previous(current()) { install(this); }
+    ~QPromiseVirtualClock() override { install(m_previous); }
+
+    qint64 now() const override { return m_now; }
+    void schedule(qint64 deadline) override { m_deadline = deadline; }
+
+    void advance(int msec)
+    {
+        const qint64 target = m_now + qMax(msec, 0);
+        while (m_deadline >= 0 && m_deadline <= target) {
+            m_now = qMax(m_now, m_deadline);
+            expire();
+        }
+
+        m_now = target;
+    }
+
+    void advance(std::chrono::milliseconds msec) { advance(static_cast<int>(msec.count())); }
+
+private:
+    QPromiseClock* m_previous;
+    qint64 m_deadline = -1;
+    qint64 m_now = 0;
+};
+
+} // namespace QtPromise
+
+#include "qpromisetimer_p.h"
+
+#endif // QTPROMISE_QPROMISECLOCK_H
@@ -11,9 +11,32 @@
 #include "qpromiseglobal.h"
 
 #include <QtCore/QException>
+#include <QtCore/QVector>
+
+#include <exception>
 
 namespace QtPromise {
 
+class QPromiseAggregateException : public QException
+{
+public:
+    QPromiseAggregateException() { }
+    explicit QPromiseAggregateException(QVector<std::exception_ptr> errors)
+        : m_errors{std::move(errors)}
+    { }
+
+    const QVector<std::exception_ptr>& errors() const { return m_errors; }
+
+    void raise() const Q_DECL_OVERRIDE { throw *this; }
+    QPromiseAggregateException* clone() const Q_DECL_OVERRIDE
+    {
+        return new QPromiseAggregateException{*this};
+    }
+
+private:
+    QVector<std::exception_ptr> m_errors;
+};
+
 class QPromiseCanceledException : public QException
 {
 public:
@@ -44,6 +67,16 @@ public:
     }
 };
 
+class QPromiseSupersededException : public QException
+{
+public:
+    void raise() const Q_DECL_OVERRIDE { throw *this; }
+    QPromiseSupersededException* clone() const Q_DECL_OVERRIDE
+    {
+        return new QPromiseSupersededException{*this};
+    }
+};
+
 class QPromiseTimeoutException : public QException
 {
 public:
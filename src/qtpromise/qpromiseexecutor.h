@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef QTPROMISE_QPROMISEEXECUTOR_H
+#define QTPROMISE_QPROMISEEXECUTOR_H
+
+#include "qpromise_p.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+#include <memory>
+#include <mutex>
+
+namespace QtPromisePrivate {
+
+class PromiseInlineExecutor : public PromiseExecutor
+{
+public:
+    bool execute(std::function<void()> fn) const Q_DECL_OVERRIDE
+    {
+        fn();
+        return true;
+    }
+};
+
+class PromiseThreadExecutor : public PromiseExecutor
+{
+public:
+    explicit PromiseThreadExecutor(QThread* thread) : m_thread{thread} { }
+
+    bool execute(std::function<void()> fn) const Q_DECL_OVERRIDE
+    {
+        if (!m_thread) {
+            return false;
+        }
+
+        qtpromise_defer(std::move(fn), m_thread);
+        return true;
+    }
+
+private:
+    QPointer<QThread> m_thread;
+};
+
+// Calls the callbacks in the thread of `context`, unless it has been destroyed meanwhile. That
+// thread is recorded when the executor is created: the settling thread never accesses `context`,
+// which is only checked from its own thread (where it's destroyed), right before the call. The
+// callbacks are also dropped if `context` has been moved to another thread meanwhile.
+class PromiseContextExecutor : public PromiseExecutor
+{
+public:
+    explicit PromiseContextExecutor(const QObject* context)
+        : m_context{const_cast<QObject*>(context)}
+        , m_thread{context ? context->thread() : nullptr}
+    { }
+
+    // Dropping the callbacks with `context` is expected (like a signal connection), so the
+    // output promise remains pending.
+    bool execute(std::function<void()> fn) const Q_DECL_OVERRIDE
+    {
+        QPointer<QObject> context = m_context;
+        qtpromise_defer(
+            [=]() {
+                if (context && context->thread() == QThread::currentThread()) {
+                    fn();
+                }
+            },
+            m_thread);
+        return true;
+    }
+
+private:
+    QPointer<QObject> m_context;
+    QPointer<QThread> m_thread;
+};
+
+// Callbacks registered by QPromise::then(context, ...): like a signal connection, they are
+// detached from the promise as soon as `context` is destroyed (releasing their captures), unless
+// one of them has already been called.
+class PromiseContextLink : public std::enable_shared_from_this<PromiseContextLink>
+{
+public:
+    template<typename F>
+    std::function<F> wrap(std::function<F> fn)
+    {
+        return Callback<F>{std::move(fn), shared_from_this()};
+    }
+
+    template<typename D>
+    void connect(const QObject* context, const QExplicitlySharedDataPointer<D>& data)
+    {
+        const void* owner = this;
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (context && !m_released) {
+            m_connection = QObject::connect(context, &QObject::destroyed, [=]() {
+                data->detach(owner);
+            });
+        }
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        QObject::disconnect(m_connection);
+        m_released = true;
+    }
+
+private:
+    template<typename F>
+    struct Callback
+    {
+        std::function<F> fn;
+        std::shared_ptr<PromiseContextLink> link;
+
+        template<typename... Args>
+        void operator()(const Args&... args) const
+        {
+            link->release();
+            fn(args...);
+        }
+    };
+
+    std::mutex m_mutex;
+    QMetaObject::Connection m_connection;
+    bool m_released = false;
+};
+
+class PromisePoolExecutor : public PromiseExecutor
+{
+public:
+    PromisePoolExecutor(QThreadPool* pool, int priority) : m_pool{pool}, m_priority{priority} { }
+
+    bool execute(std::function<void()> fn) const Q_DECL_OVERRIDE
+    {
+        auto pool = m_pool.data();
+        if (!pool) {
+            return false;
+        }
+
+        pool->start(new Runnable{std::move(fn)}, m_priority);
+        return true;
+    }
+
+private:
+    // QThreadPool::start(std::function) requires Qt 5.15.
+    class Runnable : public QRunnable
+    {
+    public:
+        explicit Runnable(std::function<void()> fn) : m_fn{std::move(fn)} { }
+        void run() Q_DECL_OVERRIDE { m_fn(); }
+
+    private:
+        std::function<void()> m_fn;
+    };
+
+    QPointer<QThreadPool> m_pool;
+    int m_priority;
+};
+
+// A custom executor returning bool reports whether it will call `fn`, else it always does.
+template<typename F>
+class PromiseFunctorExecutor : public PromiseExecutor
+{
+public:
+    explicit PromiseFunctorExecutor(F fn) : m_fn(std::move(fn)) { }
+
+    bool execute(std::function<void()> fn) const Q_DECL_OVERRIDE
+    {
+        using ResultType = typename invoke_result<const F&, std::function<void()>>::type;
+        return call(std::move(fn), std::is_same<ResultType, bool>{});
+    }
+
+private:
+    F m_fn;
+
+    bool call(std::function<void()> fn, std::true_type) const { return m_fn(std::move(fn)); }
+
+    bool call(std::function<void()> fn, std::false_type) const
+    {
+        m_fn(std::move(fn));
+        return true;
+    }
+};
+
+} // namespace QtPromisePrivate
+
+namespace QtPromise {
+
+template<typename T>
+class QPromiseBase;
+
+class QPromiseExecutor
+{
+public:
+    QPromiseExecutor() { }
+
+    template<typename F,
+             typename std::enable_if<
+                 !std::is_same<QtPromisePrivate::Unqualified<F>, QPromiseExecutor>::value,
+                 int>::type = 0>
+    explicit QPromiseExecutor(F executor)
+        : m_d{std::make_shared<QtPromisePrivate::PromiseFunctorExecutor<F>>(std::move(executor))}
+    { }
+
+    static QPromiseExecutor immediate()
+    {
+        return create<QtPromisePrivate::PromiseInlineExecutor>();
+    }
+
+    static QPromiseExecutor thread(QThread* thread)
+    {
+        return create<QtPromisePrivate::PromiseThreadExecutor>(thread);
+    }
+
+    static QPromiseExecutor context(const QObject* context)
+    {
+        return create<QtPromisePrivate::PromiseContextExecutor>(context);
+    }
+
+    static QPromiseExecutor pool(QThreadPool* pool = QThreadPool::globalInstance(),
+                                 int priority = 0)
+    {
+        return create<QtPromisePrivate::PromisePoolExecutor>(pool, priority);
+    }
+
+    bool isNull() const { return !m_d; }
+
+    // A null executor calls `fn` in the current thread (like continuations by default).
+    // Returns false if `fn` will never be called.
+    bool execute(std::function<void()> fn) const
+    {
+        if (!m_d) {
+            QtPromisePrivate::qtpromise_defer(std::move(fn));
+            return true;
+        }
+
+        return m_d->execute(std::move(fn));
+    }
+
+private:
+    template<typename T>
+    friend class QPromiseBase;
+
+    QtPromisePrivate::PromiseExecutorPtr m_d;
+
+    template<typename E, typename... Args>
+    static QPromiseExecutor create(Args&&... args)
+    {
+        QPromiseExecutor executor;
+        executor.m_d = std::make_shared<E>(std::forward<Args>(args)...);
+        return executor;
+    }
+};
+
+} // namespace QtPromise
+
+#endif // QTPROMISE_QPROMISEEXECUTOR_H
@@ -12,6 +12,9 @@
 
 #include <QtCore/QFuture>
 #include <QtCore/QFutureWatcher>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QVector>
 
 namespace QtPromisePrivate {
 
@@ -19,6 +22,118 @@ template<typename T>
 struct PromiseDeduce<QFuture<T>> : public PromiseDeduce<T>
 { };
 
+// QFutureWatcher recycled once its future is finished: futures observed from the same thread
+// (e.g. converted to or from promises) share a few watchers instead of allocating (then
+// deleting) one QObject each.
+class PromiseFutureWatcher : public QFutureWatcher<void>
+{
+public:
+    // Calls `finished` once `future` is finished, `canceled` as soon as it's canceled (i.e.
+    // maybe long before being finished), `resultsReady(begin, end)` each time results are
+    // reported and `progress(value, maximum)` each time its progress changes, if not null,
+    // from the current thread event loop.
+    static void watch(const QFuture<void>& future,
+                      std::function<void()> finished,
+                      std::function<void()> canceled = nullptr,
+                      std::function<void(int, int)> resultsReady = nullptr,
+                      std::function<void(int, int)> progress = nullptr)
+    {
+        auto& idle = pool()->watchers;
+        auto* watcher = idle.isEmpty() ? new PromiseFutureWatcher{} : idle.takeLast();
+        watcher->m_finished = std::move(finished);
+        watcher->m_canceled = std::move(canceled);
+        watcher->m_resultsReady = std::move(resultsReady);
+        watcher->m_progress = std::move(progress);
+        watcher->setFuture(future);
+    }
+
+private:
+    // Maximum number of idle watchers kept per thread, the others are deleted.
+    static const int MaxIdle = 32;
+
+    struct Pool
+    {
+        QVector<PromiseFutureWatcher*> watchers;
+        ~Pool() { qDeleteAll(watchers); }
+    };
+
+    std::function<void()> m_finished;
+    std::function<void()> m_canceled;
+    std::function<void(int, int)> m_resultsReady;
+    std::function<void(int, int)> m_progress;
+
+    PromiseFutureWatcher()
+    {
+        QObject::connect(this, &QFutureWatcherBase::progressValueChanged, [this](int value) {
+            auto progress = m_progress;
+            if (progress) {
+                progress(value, progressMaximum());
+            }
+        });
+
+        QObject::connect(this, &QFutureWatcherBase::resultsReadyAt, [this](int begin, int end) {
+            // Copied since the watcher may be finished (thus reused) while calling it.
+            auto resultsReady = m_resultsReady;
+            if (resultsReady) {
+                resultsReady(begin, end);
+            }
+        });
+
+        QObject::connect(this, &QFutureWatcherBase::canceled, [this]() {
+            auto canceled = std::move(m_canceled);
+            m_canceled = nullptr;
+            if (canceled) {
+                canceled();
+            }
+        });
+
+        // Finished is the last notification of a future, the watcher can then be reused.
+        QObject::connect(this, &QFutureWatcherBase::finished, [this]() {
+            auto finished = std::move(m_finished);
+            m_finished = nullptr;
+            m_canceled = nullptr;
+            m_resultsReady = nullptr;
+            m_progress = nullptr;
+            if (finished) {
+                finished();
+            }
+
+            auto& idle = pool()->watchers;
+            if (idle.size() < MaxIdle) {
+                idle.append(this);
+            } else {
+                deleteLater();
+            }
+        });
+    }
+
+    static Pool* pool()
+    {
+        static QThreadStorage<Pool*> storage;
+        if (!storage.hasLocalData()) {
+            storage.setLocalData(new Pool);
+        }
+
+        return storage.localData();
+    }
+};
+
+// Forwards the progress reported to `future` to the promise progress listeners (see
+// QPromise::progress), observed from the thread registering the first listener, if any,
+// using a recycled watcher (see PromiseFutureWatcher).
+struct PromiseFutureProgress
+{
+    template<typename T>
+    static void call(const QFuture<T>& future, PromiseResolver<T>& resolver)
+    {
+        QFuture<void> source = future;
+        QtPromise::QPromiseProgress<T> progress{resolver};
+        resolver.onProgressRequested([=]() {
+            PromiseFutureWatcher::watch(source, nullptr, nullptr, nullptr, progress);
+        });
+    }
+};
+
 template<typename T>
 struct PromiseFulfill<QFuture<T>>
 {
@@ -26,30 +141,32 @@ struct PromiseFulfill<QFuture<T>>
                      const QtPromise::QPromiseResolve<T>& resolve,
                      const QtPromise::QPromiseReject<T>& reject)
     {
-        using Watcher = QFutureWatcher<T>;
+        // The promise is canceled when nobody is interested anymore in its result
+        // (e.g. when losing a QtPromise::race), in which case the future work can
+        // also be stopped (if supported by the future, e.g. QtConcurrent::map).
+        QFuture<T> source = future;
+        PromiseInspect::resolver(resolve).onCancel([=]() mutable {
+            source.cancel();
+        });
 
-        Watcher* watcher = new Watcher{};
-        QObject::connect(watcher, &Watcher::finished, [=]() mutable {
+        PromiseFutureProgress::call(future, PromiseInspect::resolver(resolve));
+        PromiseFutureWatcher::watch(QFuture<void>{future}, [=]() mutable {
             try {
-                if (watcher->isCanceled()) {
+                if (source.isCanceled()) {
                     // A QFuture is canceled if cancel() has been explicitly called OR if an
                     // exception has been thrown from the associated thread. Trying to call
                     // result() in the first case causes a "read access violation", so let's
                     // rethrown potential exceptions using waitForFinished() and thus detect
                     // if the future has been canceled by the user or an exception.
-                    watcher->waitForFinished();
+                    source.waitForFinished();
                     reject(QtPromise::QPromiseCanceledException{});
                 } else {
-                    PromiseFulfill<T>::call(watcher->result(), resolve, reject);
+                    PromiseFulfill<T>::call(source.result(), resolve, reject);
                 }
             } catch (...) {
                 reject(std::current_exception());
             }
-
-            watcher->deleteLater();
         });
-
-        watcher->setFuture(future);
     }
 };
 
@@ -60,14 +177,18 @@ struct PromiseFulfill<QFuture<void>>
                      const QtPromise::QPromiseResolve<void>& resolve,
                      const QtPromise::QPromiseReject<void>& reject)
     {
-        using Watcher = QFutureWatcher<void>;
+        // stop the future work when the promise is canceled
+        QFuture<void> source = future;
+        PromiseInspect::resolver(resolve).onCancel([=]() mutable {
+            source.cancel();
+        });
 
-        Watcher* watcher = new Watcher{};
-        QObject::connect(watcher, &Watcher::finished, [=]() mutable {
+        PromiseFutureProgress::call(future, PromiseInspect::resolver(resolve));
+        PromiseFutureWatcher::watch(QFuture<void>{future}, [=]() mutable {
             try {
-                if (watcher->isCanceled()) {
+                if (source.isCanceled()) {
                     // let's rethrown potential exception
-                    watcher->waitForFinished();
+                    source.waitForFinished();
                     reject(QtPromise::QPromiseCanceledException{});
                 } else {
                     resolve();
@@ -75,14 +196,145 @@ struct PromiseFulfill<QFuture<void>>
             } catch (...) {
                 reject(std::current_exception());
             }
-
-            watcher->deleteLater();
         });
+    }
+};
 
-        watcher->setFuture(future);
+// Calls `fn(value, index)` for each result of a (multi-result) future as soon as it's reported
+// (e.g. by QtConcurrent::mapped), from the current thread event loop, instead of waiting for
+// the future to be finished (see QtPromise::eachResult).
+template<typename T>
+struct PromiseFutureStream
+{
+    template<typename F>
+    static QtPromise::QPromise<void> call(const QFuture<T>& future, F fn)
+    {
+        return QtPromise::QPromise<void>{[&](const QtPromise::QPromiseResolve<void>& resolve,
+                                             const QtPromise::QPromiseReject<void>& reject) {
+            QFuture<T> source = future;
+            PromiseInspect::resolver(resolve).onCancel([=]() mutable {
+                source.cancel();
+            });
+
+            auto failed = QSharedPointer<bool>::create(false);
+
+            auto ready = [=](int begin, int end) mutable {
+                if (*failed) {
+                    return;
+                }
+
+                try {
+                    for (int i = begin; i < end; ++i) {
+                        fn(source.resultAt(i), i);
+                    }
+                } catch (...) {
+                    // Remaining results are not needed anymore.
+                    *failed = true;
+                    reject(std::current_exception());
+                    source.cancel();
+                }
+            };
+
+            auto finished = [=]() mutable {
+                if (*failed) {
+                    return;
+                }
+
+                try {
+                    if (source.isCanceled()) {
+                        // let's rethrown potential exception
+                        source.waitForFinished();
+                        reject(QtPromise::QPromiseCanceledException{});
+                    } else {
+                        resolve();
+                    }
+                } catch (...) {
+                    reject(std::current_exception());
+                }
+            };
+
+            PromiseFutureWatcher::watch(QFuture<void>{source}, finished, nullptr, ready);
+        }};
     }
 };
 
+// Stores the rejection reason of a promise converted to a QFuture (see QPromise::toFuture),
+// which only accepts QException: the original error is rethrown from QFuture::result() or
+// QFuture::waitForFinished().
+class PromiseFutureError : public QException
+{
+public:
+    PromiseFutureError(const PromiseError& error) : m_error{error} { }
+
+    void raise() const Q_DECL_OVERRIDE { m_error.rethrow(); }
+    PromiseFutureError* clone() const Q_DECL_OVERRIDE { return new PromiseFutureError{*this}; }
+
+private:
+    PromiseError m_error;
+};
+
+template<typename T>
+struct PromiseToFuture
+{
+    static QFuture<T> call(const QExplicitlySharedDataPointer<PromiseData<T>>& data)
+    {
+        QFutureInterface<T> output;
+        output.reportStarted();
+
+        // The future is filled by a waiter, synchronously from the thread settling the promise
+        // (the promise data is alive while notifying its waiters, hence the raw pointer).
+        PromiseData<T>* input = data.data();
+        auto fill = [=]() mutable {
+            if (input->isRejected()) {
+                reportError(output, input->error());
+            } else {
+                reportValue(output, *input);
+            }
+
+            output.reportFinished();
+        };
+
+        // Canceling the future cancels the promise work (if nobody else is interested in its
+        // result, see detach), but that's only notified to a QFutureWatcher: a recycled one
+        // (see PromiseFutureWatcher), and the future interface is used as owner key.
+        auto key = std::make_shared<QFutureInterface<T>>(output);
+        auto cancel = [=]() mutable {
+            if (data->isPending()) {
+                data->removeWaiter(key.get());
+                data->detach(key.get());
+                key->reportFinished();
+            }
+        };
+
+        if (!data->addWaiter(fill, key.get())) {
+            fill();
+        }
+
+        PromiseFutureWatcher::watch(QFuture<void>{output.future()}, nullptr, cancel);
+        return output.future();
+    }
+
+private:
+    static void reportError(QFutureInterface<T>& output, const PromiseError& error)
+    {
+        try {
+            error.rethrow();
+        } catch (const QtPromise::QPromiseCanceledException&) {
+            output.reportCanceled();
+        } catch (...) {
+            output.reportException(PromiseFutureError{error});
+        }
+    }
+
+    template<typename U>
+    static void reportValue(QFutureInterface<U>& output, const PromiseData<U>& input)
+    {
+        output.reportResult(input.value().data());
+    }
+
+    static void reportValue(QFutureInterface<void>&, const PromiseData<void>&) { }
+};
+
 } // namespace QtPromisePrivate
 
 #endif // QTPROMISE_QPROMISEFUTURE_P_H
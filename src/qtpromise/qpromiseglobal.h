@@ -113,4 +113,28 @@ struct ArgsOf<R (T::*)(Args...) const volatile> : public ArgsTraits<Args...>
 
 } // namespace QtPromisePrivate
 
+namespace QtPromise {
+
+// Behavior of the helpers combining several promises (e.g. all, map) when one of them
+// is rejected. In both cases, the output promise is rejected immediately.
+enum class FailurePolicy {
+    Continue, // The other promises keep running and their values are ignored.
+    Cancel, // The other promises are detached and their work is canceled when possible.
+};
+
+// How continuations (e.g. QPromise::then callbacks) are dispatched to a thread.
+enum class DispatchMode {
+    EventLoop, // Posted to the thread event loop (default).
+    Manual, // Queued until the thread calls QtPromise::runPending (or waits for a promise).
+};
+
+// State of a promise when a blocking wait (e.g. QPromise::waitFor) returns.
+enum class WaitStatus {
+    Fulfilled,
+    Rejected,
+    Timeout, // The promise is still pending.
+};
+
+} // namespace QtPromise
+
 #endif // QTPROMISE_QPROMISEGLOBAL_H
@@ -10,6 +10,9 @@
 
 #include "qpromise_p.h"
 #include "qpromisehelpers_p.h"
+#include "qpromiseoutcome.h"
+#include "qpromisesignal.h"
+#include "qpromiseticker.h"
 
 namespace QtPromise {
 
@@ -43,31 +46,79 @@ static inline QPromise<void> resolve()
 }
 
 template<typename T, template<typename, typename...> class Sequence = QVector, typename... Args>
-static inline QPromise<QVector<T>> all(const Sequence<QPromise<T>, Args...>& promises)
+static inline QPromise<QVector<T>> all(const Sequence<QPromise<T>, Args...>& promises,
+                                       FailurePolicy policy = FailurePolicy::Continue)
 {
+    using namespace QtPromisePrivate;
+
     const int count = static_cast<int>(promises.size());
     if (count == 0) {
         return QtPromise::resolve(QVector<T>{});
     }
 
     return QPromise<QVector<T>>{
-        [=](const QPromiseResolve<QVector<T>>& resolve, const QPromiseReject<QVector<T>>& reject) {
+        [&](const QPromiseResolve<QVector<T>>& resolve, const QPromiseReject<QVector<T>>& reject) {
+            auto group = QSharedPointer<PromiseGroup>::create(policy == FailurePolicy::Cancel);
             auto remaining = QSharedPointer<int>::create(count);
             auto results = QSharedPointer<QVector<T>>::create(count);
 
             int i = 0;
             for (const auto& promise : promises) {
-                promise.then(
-                    [=](const T& res) mutable {
+                group->observe(
+                    promise,
+                    [=](const T& res) {
                         (*results)[i] = res;
+                        if (--(*remaining) == 0 && group->settle()) {
+                            resolve(*results);
+                        }
+                    },
+                    [=](const PromiseError& error) {
+                        if (group->settle()) {
+                            reject(error);
+                        }
+                    });
+
+                i++;
+            }
+        }};
+}
+
+template<template<typename, typename...> class Sequence = QVector, typename... Args>
+static inline QPromise<void> all(const Sequence<QPromise<void>, Args...>& promises,
+                                 FailurePolicy policy = FailurePolicy::Continue)
+{
+    return QtPromisePrivate::PromiseJoin::call(promises, policy == FailurePolicy::Cancel);
+}
+
+template<typename T, template<typename, typename...> class Sequence = QVector, typename... Args>
+static inline QPromise<QVector<QPromiseOutcome<T>>>
+allSettled(const Sequence<QPromise<T>, Args...>& promises)
+{
+    using OutcomeType = QPromiseOutcome<T>;
+
+    const int count = static_cast<int>(promises.size());
+    if (count == 0) {
+        return QtPromise::resolve(QVector<OutcomeType>{});
+    }
+
+    return QPromise<QVector<OutcomeType>>{
+        [=](const QPromiseResolve<QVector<OutcomeType>>& resolve) {
+            auto remaining = QSharedPointer<int>::create(count);
+            auto results = QSharedPointer<QVector<OutcomeType>>::create(count);
+
+            int i = 0;
+            for (const auto& promise : promises) {
+                promise.then(
+                    [=](const T& res) {
+                        (*results)[i] = OutcomeType::fulfilled(res);
                         if (--(*remaining) == 0) {
                             resolve(*results);
                         }
                     },
-                    [=]() mutable {
-                        if (*remaining != -1) {
-                            *remaining = -1;
-                            reject(std::current_exception());
+                    [=]() {
+                        (*results)[i] = OutcomeType::rejected(std::current_exception());
+                        if (--(*remaining) == 0) {
+                            resolve(*results);
                         }
                     });
 
@@ -77,29 +128,376 @@ static inline QPromise<QVector<T>> all(const Sequence<QPromise<T>, Args...>& pro
 }
 
 template<template<typename, typename...> class Sequence = QVector, typename... Args>
-static inline QPromise<void> all(const Sequence<QPromise<void>, Args...>& promises)
+static inline QPromise<QVector<QPromiseOutcome<void>>>
+allSettled(const Sequence<QPromise<void>, Args...>& promises)
 {
+    using OutcomeType = QPromiseOutcome<void>;
+
     const int count = static_cast<int>(promises.size());
     if (count == 0) {
-        return QtPromise::resolve();
+        return QtPromise::resolve(QVector<OutcomeType>{});
     }
 
-    return QPromise<void>{
-        [=](const QPromiseResolve<void>& resolve, const QPromiseReject<void>& reject) {
+    return QPromise<QVector<OutcomeType>>{
+        [=](const QPromiseResolve<QVector<OutcomeType>>& resolve) {
             auto remaining = QSharedPointer<int>::create(count);
+            auto results = QSharedPointer<QVector<OutcomeType>>::create(count);
 
+            int i = 0;
             for (const auto& promise : promises) {
                 promise.then(
                     [=]() {
+                        (*results)[i] = OutcomeType::fulfilled();
                         if (--(*remaining) == 0) {
-                            resolve();
+                            resolve(*results);
                         }
                     },
                     [=]() {
-                        if (*remaining != -1) {
-                            *remaining = -1;
+                        (*results)[i] = OutcomeType::rejected(std::current_exception());
+                        if (--(*remaining) == 0) {
+                            resolve(*results);
+                        }
+                    });
+
+                i++;
+            }
+        }};
+}
+
+template<typename T,
+         typename Functor,
+         template<typename, typename...> class Sequence = QVector,
+         typename... Args>
+static inline QPromise<void> asCompleted(const Sequence<QPromise<T>, Args...>& promises, Functor fn)
+{
+    using namespace QtPromisePrivate;
+    using OutcomeType = QPromiseOutcome<T>;
+
+    const int count = static_cast<int>(promises.size());
+    if (count == 0) {
+        return QtPromise::resolve();
+    }
+
+    return QPromise<void>{
+        [&](const QPromiseResolve<void>& resolve, const QPromiseReject<void>& reject) {
+            auto group = QSharedPointer<PromiseGroup>::create();
+            auto remaining = QSharedPointer<int>::create(count);
+
+            std::function<void(const OutcomeType&, int)> deliver =
+                [=](const OutcomeType& outcome, int i) {
+                    try {
+                        fn(outcome, i);
+                    } catch (...) {
+                        if (group->settle()) {
+                            reject(std::current_exception());
+                        }
+                        return;
+                    }
+
+                    if (--(*remaining) == 0 && group->settle()) {
+                        resolve();
+                    }
+                };
+
+            int i = 0;
+            for (const auto& promise : promises) {
+                group->observe(
+                    promise,
+                    [=](const T& res) {
+                        deliver(OutcomeType::fulfilled(res), i);
+                    },
+                    [=](const PromiseError& error) {
+                        try {
+                            error.rethrow();
+                        } catch (...) {
+                            deliver(OutcomeType::rejected(std::current_exception()), i);
+                        }
+                    });
+
+                i++;
+            }
+        }};
+}
+
+template<typename Functor,
+         template<typename, typename...> class Sequence = QVector,
+         typename... Args>
+static inline QPromise<void> asCompleted(const Sequence<QPromise<void>, Args...>& promises,
+                                         Functor fn)
+{
+    using namespace QtPromisePrivate;
+    using OutcomeType = QPromiseOutcome<void>;
+
+    const int count = static_cast<int>(promises.size());
+    if (count == 0) {
+        return QtPromise::resolve();
+    }
+
+    return QPromise<void>{
+        [&](const QPromiseResolve<void>& resolve, const QPromiseReject<void>& reject) {
+            auto group = QSharedPointer<PromiseGroup>::create();
+            auto remaining = QSharedPointer<int>::create(count);
+
+            std::function<void(const OutcomeType&, int)> deliver =
+                [=](const OutcomeType& outcome, int i) {
+                    try {
+                        fn(outcome, i);
+                    } catch (...) {
+                        if (group->settle()) {
                             reject(std::current_exception());
                         }
+                        return;
+                    }
+
+                    if (--(*remaining) == 0 && group->settle()) {
+                        resolve();
+                    }
+                };
+
+            int i = 0;
+            for (const auto& promise : promises) {
+                group->observe(
+                    promise,
+                    [=]() {
+                        deliver(OutcomeType::fulfilled(), i);
+                    },
+                    [=](const PromiseError& error) {
+                        try {
+                            error.rethrow();
+                        } catch (...) {
+                            deliver(OutcomeType::rejected(std::current_exception()), i);
+                        }
+                    });
+
+                i++;
+            }
+        }};
+}
+
+template<typename T, template<typename, typename...> class Sequence = QVector, typename... Args>
+static inline QPromise<T> race(const Sequence<QPromise<T>, Args...>& promises)
+{
+    using namespace QtPromisePrivate;
+
+    if (promises.size() == 0) {
+        return QPromise<T>::reject(QPromiseUndefinedException{});
+    }
+
+    return QPromise<T>{[&](const QPromiseResolve<T>& resolve, const QPromiseReject<T>& reject) {
+        auto group = QSharedPointer<PromiseGroup>::create();
+
+        for (const auto& promise : promises) {
+            group->observe(
+                promise,
+                [=](const T& res) {
+                    if (group->settle()) {
+                        resolve(res);
+                    }
+                },
+                [=](const PromiseError& error) {
+                    if (group->settle()) {
+                        reject(error);
+                    }
+                });
+        }
+    }};
+}
+
+template<template<typename, typename...> class Sequence = QVector, typename... Args>
+static inline QPromise<void> race(const Sequence<QPromise<void>, Args...>& promises)
+{
+    using namespace QtPromisePrivate;
+
+    if (promises.size() == 0) {
+        return QPromise<void>::reject(QPromiseUndefinedException{});
+    }
+
+    return QPromise<void>{
+        [&](const QPromiseResolve<void>& resolve, const QPromiseReject<void>& reject) {
+            auto group = QSharedPointer<PromiseGroup>::create();
+
+            for (const auto& promise : promises) {
+                group->observe(
+                    promise,
+                    [=]() {
+                        if (group->settle()) {
+                            resolve();
+                        }
+                    },
+                    [=](const PromiseError& error) {
+                        if (group->settle()) {
+                            reject(error);
+                        }
+                    });
+            }
+        }};
+}
+
+template<typename T, template<typename, typename...> class Sequence = QVector, typename... Args>
+static inline QPromise<T> any(const Sequence<QPromise<T>, Args...>& promises)
+{
+    using namespace QtPromisePrivate;
+
+    const int count = static_cast<int>(promises.size());
+    if (count == 0) {
+        return QPromise<T>::reject(QPromiseAggregateException{});
+    }
+
+    return QPromise<T>{[&](const QPromiseResolve<T>& resolve, const QPromiseReject<T>& reject) {
+        auto group = QSharedPointer<PromiseGroup>::create();
+        auto errors = QSharedPointer<QVector<std::exception_ptr>>::create(count);
+        auto remaining = QSharedPointer<int>::create(count);
+
+        int i = 0;
+        for (const auto& promise : promises) {
+            group->observe(
+                promise,
+                [=](const T& res) {
+                    if (group->settle()) {
+                        resolve(res);
+                    }
+                },
+                [=](const PromiseError& error) {
+                    try {
+                        error.rethrow();
+                    } catch (...) {
+                        (*errors)[i] = std::current_exception();
+                    }
+
+                    if (--(*remaining) == 0 && group->settle()) {
+                        reject(QPromiseAggregateException{*errors});
+                    }
+                });
+
+            i++;
+        }
+    }};
+}
+
+template<template<typename, typename...> class Sequence = QVector, typename... Args>
+static inline QPromise<void> any(const Sequence<QPromise<void>, Args...>& promises)
+{
+    using namespace QtPromisePrivate;
+
+    const int count = static_cast<int>(promises.size());
+    if (count == 0) {
+        return QPromise<void>::reject(QPromiseAggregateException{});
+    }
+
+    return QPromise<void>{
+        [&](const QPromiseResolve<void>& resolve, const QPromiseReject<void>& reject) {
+            auto group = QSharedPointer<PromiseGroup>::create();
+            auto errors = QSharedPointer<QVector<std::exception_ptr>>::create(count);
+            auto remaining = QSharedPointer<int>::create(count);
+
+            int i = 0;
+            for (const auto& promise : promises) {
+                group->observe(
+                    promise,
+                    [=]() {
+                        if (group->settle()) {
+                            resolve();
+                        }
+                    },
+                    [=](const PromiseError& error) {
+                        try {
+                            error.rethrow();
+                        } catch (...) {
+                            (*errors)[i] = std::current_exception();
+                        }
+
+                        if (--(*remaining) == 0 && group->settle()) {
+                            reject(QPromiseAggregateException{*errors});
+                        }
+                    });
+
+                i++;
+            }
+        }};
+}
+
+template<typename T, template<typename, typename...> class Sequence = QVector, typename... Args>
+static inline QPromise<QVector<T>> some(const Sequence<QPromise<T>, Args...>& promises, int count)
+{
+    using namespace QtPromisePrivate;
+
+    const int size = static_cast<int>(promises.size());
+    if (count <= 0) {
+        return QPromise<QVector<T>>::resolve(QVector<T>{});
+    }
+    if (count > size) {
+        return QPromise<QVector<T>>::reject(QPromiseAggregateException{});
+    }
+
+    return QPromise<QVector<T>>{
+        [&](const QPromiseResolve<QVector<T>>& resolve, const QPromiseReject<QVector<T>>& reject) {
+            auto group = QSharedPointer<PromiseGroup>::create();
+            auto values = QSharedPointer<QVector<T>>::create();
+            auto errors = QSharedPointer<QVector<std::exception_ptr>>::create();
+
+            values->reserve(count);
+
+            for (const auto& promise : promises) {
+                group->observe(
+                    promise,
+                    [=](const T& res) {
+                        values->append(res);
+                        if (values->size() == count && group->settle()) {
+                            resolve(*values);
+                        }
+                    },
+                    [=](const PromiseError& error) {
+                        try {
+                            error.rethrow();
+                        } catch (...) {
+                            errors->append(std::current_exception());
+                        }
+
+                        if (errors->size() > size - count && group->settle()) {
+                            reject(QPromiseAggregateException{*errors});
+                        }
+                    });
+            }
+        }};
+}
+
+template<template<typename, typename...> class Sequence = QVector, typename... Args>
+static inline QPromise<void> some(const Sequence<QPromise<void>, Args...>& promises, int count)
+{
+    using namespace QtPromisePrivate;
+
+    const int size = static_cast<int>(promises.size());
+    if (count <= 0) {
+        return QPromise<void>::resolve();
+    }
+    if (count > size) {
+        return QPromise<void>::reject(QPromiseAggregateException{});
+    }
+
+    return QPromise<void>{
+        [&](const QPromiseResolve<void>& resolve, const QPromiseReject<void>& reject) {
+            auto group = QSharedPointer<PromiseGroup>::create();
+            auto errors = QSharedPointer<QVector<std::exception_ptr>>::create();
+            auto fulfilled = QSharedPointer<int>::create(0);
+
+            for (const auto& promise : promises) {
+                group->observe(
+                    promise,
+                    [=]() {
+                        if (++(*fulfilled) == count && group->settle()) {
+                            resolve();
+                        }
+                    },
+                    [=](const PromiseError& error) {
+                        try {
+                            error.rethrow();
+                        } catch (...) {
+                            errors->append(std::current_exception());
+                        }
+
+                        if (errors->size() > size - count && group->settle()) {
+                            reject(QPromiseAggregateException{*errors});
+                        }
                     });
             }
         }};
@@ -129,6 +527,97 @@ attempt(Functor&& fn, Args&&... args)
     }};
 }
 
+template<typename Functor, typename... Args>
+static inline typename QtPromisePrivate::PromiseRun<Functor, Args...>::PromiseType
+run(const QPromiseExecutor& executor, Functor fn, Args... args)
+{
+    return QtPromisePrivate::PromiseRun<Functor, Args...>::call(executor,
+                                                                std::move(fn),
+                                                                std::move(args)...);
+}
+
+template<typename Functor, typename... Args>
+static inline typename QtPromisePrivate::PromiseRun<Functor, Args...>::PromiseType
+run(QThreadPool* pool, Functor fn, Args... args)
+{
+    return run(QPromiseExecutor::pool(pool), std::move(fn), std::move(args)...);
+}
+
+template<typename Functor, typename... Args>
+static inline typename QtPromisePrivate::PromiseRun<Functor, Args...>::PromiseType
+run(const QPromiseThreadPool& pool, Functor fn, Args... args)
+{
+    return run(pool.executor(), std::move(fn), std::move(args)...);
+}
+
+template<typename Functor>
+static inline typename QtPromisePrivate::PromiseFunctor<Functor>::PromiseType
+hedge(Functor fn, int msec, int attempts)
+{
+    using namespace QtPromisePrivate;
+    using FunctorType = PromiseFunctor<Functor>;
+    using PromiseType = typename FunctorType::PromiseType;
+    using ValueType = typename PromiseType::Type;
+    using InvokeType = PromiseInvoke<Unqualified<typename FunctorType::ResultType>>;
+    using HedgeType = PromiseHedge<ValueType>;
+
+    Q_ASSERT(attempts > 0);
+
+    return PromiseType{
+        [&](const QPromiseResolve<ValueType>& resolve, const QPromiseReject<ValueType>& reject) {
+            auto hedge = QSharedPointer<HedgeType>::create(
+                [=]() {
+                    return InvokeType::call(fn);
+                },
+                qMax(attempts, 1),
+                resolve,
+                reject);
+
+            HedgeType::start(hedge, msec);
+        }};
+}
+
+template<typename Functor>
+static inline typename QtPromisePrivate::PromiseFunctor<Functor>::PromiseType
+hedge(Functor fn, std::chrono::milliseconds msec, int attempts)
+{
+    return hedge(std::move(fn), static_cast<int>(msec.count()), attempts);
+}
+
+template<typename Functor>
+static inline typename QtPromisePrivate::PromiseCoalesced<Functor>::Type debounce(Functor fn,
+                                                                                  int msec)
+{
+    return QtPromisePrivate::PromiseCoalesced<Functor>::create(std::move(fn), msec, false);
+}
+
+template<typename Functor>
+static inline typename QtPromisePrivate::PromiseCoalesced<Functor>::Type
+debounce(Functor fn, std::chrono::milliseconds msec)
+{
+    return debounce(std::move(fn), static_cast<int>(msec.count()));
+}
+
+template<typename Functor>
+static inline typename QtPromisePrivate::PromiseCoalesced<Functor>::Type throttle(Functor fn,
+                                                                                  int msec)
+{
+    return QtPromisePrivate::PromiseCoalesced<Functor>::create(std::move(fn), msec, true);
+}
+
+template<typename Functor>
+static inline typename QtPromisePrivate::PromiseCoalesced<Functor>::Type
+throttle(Functor fn, std::chrono::milliseconds msec)
+{
+    return throttle(std::move(fn), static_cast<int>(msec.count()));
+}
+
+template<typename Functor>
+static inline typename QtPromisePrivate::PromiseLatest<Functor>::Type latest(Functor fn)
+{
+    return QtPromisePrivate::PromiseLatest<Functor>::create(std::move(fn));
+}
+
 template<typename Sender, typename Signal>
 static inline typename QtPromisePrivate::PromiseFromSignal<Signal>
 connect(const Sender* sender, Signal signal)
@@ -165,15 +654,61 @@ connect(const Sender* sender, FSignal fsignal, RSignal rsignal)
     return connect(sender, fsignal, sender, rsignal);
 }
 
+template<typename Sender, typename Signal>
+static inline QPromiseSignal<typename QtPromisePrivate::PromiseFromSignal<Signal>::Type>
+listen(const Sender* sender, Signal signal)
+{
+    using T = typename QtPromisePrivate::PromiseFromSignal<Signal>::Type;
+    return QPromiseSignal<T>{sender, signal};
+}
+
+template<typename T>
+static inline QPromise<QVector<T>> collect(const QFuture<T>& future)
+{
+    auto values = QSharedPointer<QVector<T>>::create();
+
+    // Results are copied once, as reported, instead of copying them all at once at the end
+    // using QFuture::results() (which also converts them to a QList).
+    auto store = [=](const T& value, int index) {
+        if (index >= values->size()) {
+            values->resize(index + 1);
+        }
+
+        (*values)[index] = value;
+    };
+
+    // Nobody else accesses the values once the stream is finished, so they can be moved.
+    return QtPromisePrivate::PromiseFutureStream<T>::call(future, store).then([=]() {
+        return std::move(*values);
+    });
+}
+
 template<typename Sequence, typename Functor>
-static inline QPromise<Sequence> each(const Sequence& values, Functor&& fn)
+static inline QPromise<Sequence>
+each(const Sequence& values, Functor&& fn, FailurePolicy policy = FailurePolicy::Continue)
 {
-    return QPromise<Sequence>::resolve(values).each(std::forward<Functor>(fn));
+    return QPromise<Sequence>::resolve(values).each(std::forward<Functor>(fn), policy);
+}
+
+template<typename T, typename Functor>
+static inline QPromise<void> eachResult(const QFuture<T>& future, Functor fn)
+{
+    return QtPromisePrivate::PromiseFutureStream<T>::call(future, std::move(fn));
+}
+
+static inline QPromiseTicker every(int msec)
+{
+    return QPromiseTicker{msec};
+}
+
+static inline QPromiseTicker every(std::chrono::milliseconds msec)
+{
+    return QPromiseTicker{msec};
 }
 
 template<typename Sequence, typename Functor>
 static inline typename QtPromisePrivate::PromiseMapper<Sequence, Functor>::PromiseType
-map(const Sequence& values, Functor fn)
+map(const Sequence& values, Functor fn, FailurePolicy policy = FailurePolicy::Continue)
 {
     using namespace QtPromisePrivate;
     using MapperType = PromiseMapper<Sequence, Functor>;
@@ -182,23 +717,24 @@ map(const Sequence& values, Functor fn)
 
     int i = 0;
 
+    // The promises returned by fn are used as-is so they can be canceled on failure.
     std::vector<QPromise<ResType>> promises;
     for (const auto& v : values) {
-        promises.push_back(QPromise<ResType>{
-            [&](const QPromiseResolve<ResType>& resolve, const QPromiseReject<ResType>& reject) {
-                PromiseFulfill<RetType>::call(fn(v, i), resolve, reject);
-            }});
+        promises.push_back(PromiseInvoke<Unqualified<RetType>>::call([&]() {
+            return fn(v, i);
+        }));
 
         i++;
     }
 
-    return QtPromise::all(promises);
+    return QtPromise::all(promises, policy);
 }
 
 template<typename Sequence, typename Functor>
-static inline QPromise<Sequence> filter(const Sequence& values, Functor fn)
+static inline QPromise<Sequence>
+filter(const Sequence& values, Functor fn, FailurePolicy policy = FailurePolicy::Continue)
 {
-    return QtPromise::map(values, fn).then([=](const QVector<bool>& filters) {
+    return QtPromise::map(values, fn, policy).then([=](const QVector<bool>& filters) {
         Sequence filtered;
 
         auto filter = filters.begin();
@@ -214,6 +750,46 @@ static inline QPromise<Sequence> filter(const Sequence& values, Functor fn)
     });
 }
 
+template<typename Sequence, typename Functor>
+static inline QPromise<int> findIndex(const Sequence& values, Functor fn, int concurrency = 1)
+{
+    using SearchType = QtPromisePrivate::PromiseSearch<Sequence, Functor>;
+    return SearchType::search(values, std::move(fn), true, true, concurrency);
+}
+
+template<typename Sequence, typename Functor>
+static inline QPromise<typename Sequence::value_type>
+find(const Sequence& values, Functor fn, int concurrency = 1)
+{
+    using ValueType = typename Sequence::value_type;
+
+    return QtPromise::findIndex(values, std::move(fn), concurrency).then([=](int index) {
+        return index < 0 ? ValueType{} : *std::next(values.cbegin(), index);
+    });
+}
+
+template<typename Sequence, typename Functor>
+static inline QPromise<bool> someMatch(const Sequence& values, Functor fn, int concurrency = 1)
+{
+    using SearchType = QtPromisePrivate::PromiseSearch<Sequence, Functor>;
+
+    // The first value matching the predicate (in completion order) answers the question.
+    return SearchType::search(values, std::move(fn), true, false, concurrency).then([](int index) {
+        return index >= 0;
+    });
+}
+
+template<typename Sequence, typename Functor>
+static inline QPromise<bool> everyMatch(const Sequence& values, Functor fn, int concurrency = 1)
+{
+    using SearchType = QtPromisePrivate::PromiseSearch<Sequence, Functor>;
+
+    // The first value NOT matching the predicate (in completion order) answers the question.
+    return SearchType::search(values, std::move(fn), false, false, concurrency).then([](int index) {
+        return index < 0;
+    });
+}
+
 template<typename T,
          template<typename...> class Sequence = QVector,
          typename Reducer,
@@ -274,6 +850,40 @@ reduce(const Sequence<T, Args...>& values, Reducer fn)
     return promise;
 }
 
+static inline int runPending(int maxItems, std::chrono::milliseconds timeBudget)
+{
+    using Clock = QtPromisePrivate::PromiseQueue::Clock;
+
+    // A budget which is not positive is unlimited, a huge one is clamped to the clock range.
+    const auto now = Clock::now();
+    const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        Clock::time_point::max() - now);
+
+    const auto deadline = timeBudget <= std::chrono::milliseconds::zero() || timeBudget >= remaining
+        ? Clock::time_point::max()
+        : now + timeBudget;
+
+    return QtPromisePrivate::PromiseQueue::of(QThread::currentThread())->run(maxItems, deadline);
+}
+
+static inline int runPending(int maxItems = -1, int msec = -1)
+{
+    return runPending(maxItems, std::chrono::milliseconds{msec});
+}
+
+static inline DispatchMode dispatchMode()
+{
+    return QtPromisePrivate::PromiseQueue::isManual(QThread::currentThread())
+        ? DispatchMode::Manual
+        : DispatchMode::EventLoop;
+}
+
+static inline void setDispatchMode(DispatchMode mode)
+{
+    QtPromisePrivate::PromiseQueue::of(QThread::currentThread())
+        ->setManual(mode == DispatchMode::Manual);
+}
+
 // DEPRECATIONS (remove at version 1)
 
 template<typename... Args>
@@ -10,70 +10,626 @@
 
 #include "qpromiseconnections.h"
 #include "qpromiseexceptions.h"
+#include "qpromisesignal.h"
+#include "qpromisethreadpool.h"
+#include "qpromisetimer_p.h"
 
 namespace QtPromisePrivate {
 
-// TODO: Suppress QPrivateSignal trailing private signal args
-// TODO: Support deducing tuple from args (might require MSVC2017)
+// Shared state of the helpers which may settle before all of their input promises
+// (e.g. race, any): once settled, the callbacks still registered on the remaining
+// input promises are detached and, if `cancel` is true, their work canceled when
+// possible (see detach).
+class PromiseGroup
+{
+public:
+    explicit PromiseGroup(bool cancel = true) : m_cancel{cancel} { }
 
-template<typename Signal>
-using PromiseFromSignal = typename QtPromise::QPromise<Unqualified<typename ArgsOf<Signal>::first>>;
-
-// Connect signal() to QPromiseResolve
-template<typename Sender, typename Signal>
-typename std::enable_if<(ArgsOf<Signal>::count == 0)>::type
-connectSignalToResolver(const QtPromise::QPromiseConnections& connections,
-                        const QtPromise::QPromiseResolve<void>& resolve,
-                        const Sender* sender,
-                        Signal signal)
+    template<typename T, typename TFulfilled, typename TRejected>
+    void observe(const QtPromise::QPromise<T>& promise, TFulfilled fulfilled, TRejected rejected)
+    {
+        QExplicitlySharedDataPointer<PromiseData<T>> input{PromiseInspect::get(promise)};
+        input->addCallbacks(std::move(fulfilled), std::move(rejected), this);
+        m_inputs.append([=](bool cancel) {
+            input->detach(this, cancel);
+        });
+
+        if (!input->isPending()) {
+            input->dispatch();
+        }
+    }
+
+    bool isSettled() const { return m_settled; }
+
+    // Returns false if the group has already been settled, in which case the caller
+    // must not resolve or reject the output promise.
+    bool settle()
+    {
+        if (m_settled) {
+            return false;
+        }
+
+        m_settled = true;
+
+        // Also breaks the circular references between the inputs and this group.
+        const auto inputs = std::move(m_inputs);
+        for (const auto& detach : inputs) {
+            detach(m_cancel);
+        }
+
+        return true;
+    }
+
+private:
+    bool m_cancel;
+    bool m_settled = false;
+    QVector<std::function<void(bool)>> m_inputs;
+};
+
+// Fulfilled once all `promises` are fulfilled (ignoring their values) or rejected as
+// soon as one of them is rejected (e.g. QtPromise::all<void>, QtPromise::each).
+struct PromiseJoin
 {
-    connections << QObject::connect(sender, signal, [=]() {
-        connections.disconnect();
-        resolve();
-    });
-}
+    template<typename Sequence>
+    static QtPromise::QPromise<void> call(const Sequence& promises, bool cancel)
+    {
+        const int count = static_cast<int>(promises.size());
+        if (count == 0) {
+            return QtPromise::QPromise<void>::resolve();
+        }
 
-// Connect signal() to QPromiseReject
-template<typename T, typename Sender, typename Signal>
-typename std::enable_if<(ArgsOf<Signal>::count == 0)>::type
-connectSignalToResolver(const QtPromise::QPromiseConnections& connections,
-                        const QtPromise::QPromiseReject<T>& reject,
-                        const Sender* sender,
-                        Signal signal)
+        return QtPromise::QPromise<void>{[&](const QtPromise::QPromiseResolve<void>& resolve,
+                                             const QtPromise::QPromiseReject<void>& reject) {
+            auto group = QSharedPointer<PromiseGroup>::create(cancel);
+            auto remaining = QSharedPointer<int>::create(count);
+
+            for (const auto& promise : promises) {
+                group->observe(promise,
+                               Fulfilled{group, remaining, resolve},
+                               [=](const PromiseError& error) {
+                                   if (group->settle()) {
+                                       reject(error);
+                                   }
+                               });
+            }
+        }};
+    }
+
+private:
+    struct Fulfilled
+    {
+        QSharedPointer<PromiseGroup> group;
+        QSharedPointer<int> remaining;
+        QtPromise::QPromiseResolve<void> resolve;
+
+        template<typename... V>
+        void operator()(const V&...) const
+        {
+            if (--(*remaining) == 0 && group->settle()) {
+                resolve();
+            }
+        }
+    };
+};
+
+// Calls fn() and returns its result as a promise (similar to QtPromise::attempt) but
+// returns the promise unchanged if fn() already returns a QPromise, so callbacks can
+// later be detached from it (see PromiseGroup).
+template<typename Result>
+struct PromiseInvoke
+{
+    template<typename Functor>
+    static typename PromiseDeduce<Result>::Type call(const Functor& fn)
+    {
+        using PromiseType = typename PromiseDeduce<Result>::Type;
+        using ValueType = typename PromiseType::Type;
+
+        return PromiseType{[&](const QtPromise::QPromiseResolve<ValueType>& resolve,
+                               const QtPromise::QPromiseReject<ValueType>& reject) {
+            PromiseDispatch<Result>::call(resolve, reject, fn);
+        }};
+    }
+};
+
+template<typename T>
+struct PromiseInvoke<QtPromise::QPromise<T>>
+{
+    template<typename Functor>
+    static QtPromise::QPromise<T> call(const Functor& fn)
+    {
+        try {
+            return fn();
+        } catch (...) {
+            return QtPromise::QPromise<T>::reject(std::current_exception());
+        }
+    }
+};
+
+// Implementation of QtPromise::hedge: a new attempt is started each time the timer
+// expires or an attempt is rejected, until the maximum number of attempts. A single
+// timer is shared by all the attempts and released as soon as no more attempt can
+// be started, while the remaining attempts are detached when the first one fulfills.
+template<typename T>
+class PromiseHedge
+{
+public:
+    using Self = QSharedPointer<PromiseHedge<T>>;
+    using Attempt = std::function<QtPromise::QPromise<T>()>;
+
+    PromiseHedge(Attempt attempt,
+                 int attempts,
+                 const QtPromise::QPromiseResolve<T>& resolve,
+                 const QtPromise::QPromiseReject<T>& reject)
+        : m_attempt{std::move(attempt)}
+        , m_attempts{attempts}
+        , m_resolve{resolve}
+        , m_reject{reject}
+    { }
+
+    ~PromiseHedge() { Q_ASSERT(!m_timer.isActive()); }
+
+    static void start(const Self& self, int msec)
+    {
+        self->m_interval = msec;
+        launch(self);
+    }
+
+private:
+    struct Fulfilled
+    {
+        Self self;
+
+        template<typename... V>
+        void operator()(const V&... value) const
+        {
+            if (self->m_group.settle()) {
+                self->releaseTimer();
+                self->m_resolve(value...);
+            }
+        }
+    };
+
+    PromiseGroup m_group;
+    Attempt m_attempt;
+    QVector<std::exception_ptr> m_errors;
+    int m_attempts;
+    int m_interval = 0;
+    int m_started = 0;
+    int m_pending = 0;
+    QtPromise::QPromiseResolve<T> m_resolve;
+    QtPromise::QPromiseReject<T> m_reject;
+    PromiseTimer m_timer;
+
+    static void launch(const Self& self)
+    {
+        if (self->m_group.isSettled() || self->m_started == self->m_attempts) {
+            return;
+        }
+
+        // (Re)start the timer since this attempt may have been started early.
+        self->releaseTimer();
+        if (++self->m_started < self->m_attempts) {
+            self->m_timer = PromiseTimer::start(self->m_interval, [=]() {
+                launch(self);
+            });
+        }
+
+        self->m_pending++;
+        self->m_group.observe(self->m_attempt(),
+                              Fulfilled{self},
+                              [=](const PromiseError& error) {
+                                  try {
+                                      error.rethrow();
+                                  } catch (...) {
+                                      self->m_errors.append(std::current_exception());
+                                  }
+
+                                  // No need to wait for the timer to start the next attempt.
+                                  if (--self->m_pending == 0
+                                      && self->m_started == self->m_attempts
+                                      && self->m_group.settle()) {
+                                      self->m_reject(
+                                          QtPromise::QPromiseAggregateException{self->m_errors});
+                                  } else {
+                                      launch(self);
+                                  }
+                              });
+    }
+
+    void releaseTimer()
+    {
+        // The timer callback holds a reference to this object, stopping
+        // the timer releases the callback and breaks this circular reference.
+        m_timer.stop();
+    }
+};
+
+// Implementation of QtPromise::debounce and QtPromise::throttle: the calls made during the
+// same window are coalesced onto a single execution of the latest call, whose result settles
+// the promises returned to all of them. With `leading` (throttle), a call made while no window
+// is open is executed right away and opens a window, as does each coalesced execution.
+template<typename T>
+class PromiseCoalesce : public std::enable_shared_from_this<PromiseCoalesce<T>>
+{
+public:
+    using Call = std::function<QtPromise::QPromise<T>()>;
+
+    PromiseCoalesce(int msec, bool leading) : m_interval{qMax(msec, 0)}, m_leading{leading} { }
+
+    ~PromiseCoalesce()
+    {
+        m_timer.stop();
+        for (auto& waiter : m_waiters) {
+            waiter.reject(QtPromise::QPromiseCanceledException{});
+        }
+    }
+
+    QtPromise::QPromise<T> push(Call call)
+    {
+        if (m_leading && !m_timer.isActive()) {
+            schedule();
+            return call();
+        }
+
+        if (!m_leading) {
+            schedule();
+        }
+
+        m_call = std::move(call);
+        return QtPromise::QPromise<T>{
+            [&](const QtPromise::QPromiseResolve<T>& resolve, const QtPromise::QPromiseReject<T>&) {
+                m_waiters.push_back(PromiseInspect::resolver(resolve));
+            }};
+    }
+
+private:
+    struct Resolve
+    {
+        std::vector<PromiseResolver<T>> waiters;
+
+        template<typename... V>
+        void operator()(const V&... value) const
+        {
+            for (auto waiter : waiters) {
+                waiter.resolve(value...);
+            }
+        }
+    };
+
+    struct Reject
+    {
+        std::vector<PromiseResolver<T>> waiters;
+
+        void operator()(const PromiseError& error) const
+        {
+            for (auto waiter : waiters) {
+                waiter.reject(error);
+            }
+        }
+    };
+
+    Call m_call;
+    std::vector<PromiseResolver<T>> m_waiters;
+    PromiseTimer m_timer;
+    int m_interval;
+    bool m_leading;
+
+    void schedule()
+    {
+        std::weak_ptr<PromiseCoalesce<T>> weak = this->shared_from_this();
+        m_timer.stop();
+        m_timer = PromiseTimer::start(m_interval, [=]() {
+            if (auto self = weak.lock()) {
+                self->fire();
+            }
+        });
+    }
+
+    void fire()
+    {
+        if (m_waiters.empty()) {
+            return;
+        }
+
+        std::vector<PromiseResolver<T>> waiters;
+        std::swap(waiters, m_waiters);
+        Call call;
+        std::swap(call, m_call);
+
+        if (m_leading) {
+            schedule();
+        }
+
+        PromiseFulfill<QtPromise::QPromise<T>>::call(call(), Resolve{waiters}, Reject{waiters});
+    }
+};
+
+// Wraps `fn` in a PromiseCoalesce, returning a std::function with the same arguments as `fn`.
+template<typename Functor, typename Args = typename ArgsOf<Functor>::types>
+struct PromiseCoalesced;
+
+template<typename Functor, typename... Args>
+struct PromiseCoalesced<Functor, std::tuple<Args...>>
+{
+    using FunctorType = PromiseFunctor<Functor, Args...>;
+    using PromiseType = typename FunctorType::PromiseType;
+    using InvokeType = PromiseInvoke<Unqualified<typename FunctorType::ResultType>>;
+    using Type = std::function<PromiseType(Args...)>;
+
+    static Type create(Functor fn, int msec, bool leading)
+    {
+        auto d = std::make_shared<PromiseCoalesce<typename PromiseType::Type>>(msec, leading);
+        return [=](Args... args) {
+            // Arguments are captured by value, the call may be executed later.
+            return d->push([=]() {
+                return InvokeType::call([&]() {
+                    return fn(args...);
+                });
+            });
+        };
+    }
+};
+
+// Implementation of QtPromise::latest: each call supersedes the previous one, whose output
+// promise is rejected with QPromiseSupersededException while its callbacks are detached from
+// the promise returned by `fn`, canceling the underlying work if possible (see PromiseGroup).
+template<typename Functor, typename Args = typename ArgsOf<Functor>::types>
+struct PromiseLatest;
+
+template<typename Functor, typename... Args>
+struct PromiseLatest<Functor, std::tuple<Args...>>
+{
+    using FunctorType = PromiseFunctor<Functor, Args...>;
+    using PromiseType = typename FunctorType::PromiseType;
+    using ValueType = typename PromiseType::Type;
+    using InvokeType = PromiseInvoke<Unqualified<typename FunctorType::ResultType>>;
+    using Type = std::function<PromiseType(Args...)>;
+
+    static Type create(Functor fn)
+    {
+        auto current = std::make_shared<std::function<void()>>();
+        return [=](Args... args) {
+            // The superseded work is canceled before starting the new one.
+            std::function<void()> supersede;
+            std::swap(supersede, *current);
+            if (supersede) {
+                supersede();
+            }
+
+            auto input = InvokeType::call([&]() {
+                return fn(args...);
+            });
+
+            return PromiseType{[&](const QtPromise::QPromiseResolve<ValueType>& resolve,
+                                   const QtPromise::QPromiseReject<ValueType>& reject) {
+                auto group = QSharedPointer<PromiseGroup>::create();
+                group->observe(input, Fulfilled{group, resolve}, [=](const PromiseError& error) {
+                    if (group->settle()) {
+                        reject(error);
+                    }
+                });
+
+                *current = [=]() {
+                    if (group->settle()) {
+                        reject(QtPromise::QPromiseSupersededException{});
+                    }
+                };
+            }};
+        };
+    }
+
+private:
+    struct Fulfilled
+    {
+        QSharedPointer<PromiseGroup> group;
+        QtPromise::QPromiseResolve<ValueType> resolve;
+
+        template<typename... V>
+        void operator()(const V&... value) const
+        {
+            if (group->settle()) {
+                resolve(value...);
+            }
+        }
+    };
+};
+
+// Implementation of QtPromise::run: calls `fn(args...)` from a task started through `executor`
+// and settles the promise directly from that task. If the promise is canceled before the task
+// starts (see PromiseResolver::onCancel) or if `executor` drops the task (e.g. the thread pool
+// has been destroyed), `fn` is not called and the promise is rejected with
+// QPromiseCanceledException.
+template<typename Functor, typename... Args>
+struct PromiseRun
+{
+    using FunctorType = PromiseFunctor<Functor&, Args&...>;
+    using PromiseType = typename FunctorType::PromiseType;
+    using ValueType = typename PromiseType::Type;
+
+    static PromiseType call(const QtPromise::QPromiseExecutor& executor, Functor fn, Args... args)
+    {
+        return PromiseType{[&](const QtPromise::QPromiseResolve<ValueType>& resolve,
+                               const QtPromise::QPromiseReject<ValueType>& reject) {
+            auto canceled = std::make_shared<std::atomic<bool>>(false);
+            PromiseInspect::resolver(resolve).onCancel([=]() {
+                *canceled = true;
+            });
+
+            const bool started = executor.execute([=]() mutable {
+                if (*canceled) {
+                    reject(QtPromise::QPromiseCanceledException{});
+                } else {
+                    PromiseDispatch<typename FunctorType::ResultType>::call(resolve,
+                                                                            reject,
+                                                                            fn,
+                                                                            args...);
+                }
+            });
+
+            if (!started) {
+                reject(QtPromise::QPromiseCanceledException{});
+            }
+        }};
+    }
+};
+
+// Implementation of the QtPromise::find* helpers: evaluates `fn(value, index)` on at most
+// `concurrency` values at once and stops scheduling new evaluations as soon as the result
+// is known, i.e. when a predicate returns `expected`. If `ordered` is true, the resolved
+// index is the lowest one for which a predicate returns `expected`, else the first one to
+// be reported. The search is resolved with -1 if no predicate returns `expected`.
+template<typename Sequence, typename Functor>
+class PromiseSearch
 {
-    connections << QObject::connect(sender, signal, [=]() {
+public:
+    using Self = QSharedPointer<PromiseSearch<Sequence, Functor>>;
+    using ValueType = typename Sequence::value_type;
+    using ResultType = typename invoke_result<Functor, ValueType, int>::type;
+
+    PromiseSearch(const Sequence& values,
+                  Functor fn,
+                  bool expected,
+                  bool ordered,
+                  int concurrency,
+                  const QtPromise::QPromiseResolve<int>& resolve,
+                  const QtPromise::QPromiseReject<int>& reject)
+        : m_values(values)
+        , m_next(m_values.cbegin())
+        , m_fn(std::move(fn))
+        , m_expected(expected)
+        , m_ordered(ordered)
+        , m_concurrency(qMax(concurrency, 1))
+        , m_resolve(resolve)
+        , m_reject(reject)
+    { }
+
+    static QtPromise::QPromise<int>
+    search(const Sequence& values, Functor fn, bool expected, bool ordered, int concurrency)
+    {
+        return QtPromise::QPromise<int>{[&](const QtPromise::QPromiseResolve<int>& resolve,
+                                            const QtPromise::QPromiseReject<int>& reject) {
+            schedule(Self::create(values,
+                                  std::move(fn),
+                                  expected,
+                                  ordered,
+                                  concurrency,
+                                  resolve,
+                                  reject));
+        }};
+    }
+
+private:
+    PromiseGroup m_group;
+    Sequence m_values;
+    typename Sequence::const_iterator m_next;
+    Functor m_fn;
+    QVector<bool> m_evaluated;
+    bool m_expected;
+    bool m_ordered;
+    int m_concurrency;
+    int m_count = 0;
+    int m_running = 0;
+    int m_evaluatedCount = 0;
+    int m_found = -1;
+    QtPromise::QPromiseResolve<int> m_resolve;
+    QtPromise::QPromiseReject<int> m_reject;
+
+    static void schedule(const Self& self)
+    {
+        while (!self->m_group.isSettled() && self->m_found == -1
+               && self->m_running < self->m_concurrency && self->m_next != self->m_values.cend()) {
+            const int index = self->m_count++;
+            const auto& value = *self->m_next++;
+
+            self->m_evaluated.append(false);
+            self->m_running++;
+            self->m_group.observe(
+                PromiseInvoke<Unqualified<ResultType>>::call([&]() {
+                    return self->m_fn(value, index);
+                }),
+                [=](bool result) {
+                    self->m_running--;
+                    self->evaluated(index, result);
+                    schedule(self);
+                },
+                [=](const PromiseError& error) {
+                    if (self->m_group.settle()) {
+                        self->m_reject(error);
+                    }
+                });
+        }
+
+        if (self->m_running == 0 && self->m_group.settle()) {
+            self->m_resolve(self->m_found);
+        }
+    }
+
+    void evaluated(int index, bool result)
+    {
+        if (result == m_expected) {
+            if (!m_ordered) {
+                if (m_group.settle()) {
+                    m_resolve(index);
+                }
+                return;
+            }
+
+            if (m_found == -1 || index < m_found) {
+                m_found = index;
+            }
+        }
+
+        m_evaluated[index] = true;
+        while (m_evaluatedCount < m_evaluated.size() && m_evaluated[m_evaluatedCount]) {
+            m_evaluatedCount++;
+        }
+
+        // All the values preceding the match have been evaluated: no need to wait
+        // for the evaluations of the following values, which are still running.
+        if (m_found != -1 && m_evaluatedCount > m_found && m_group.settle()) {
+            m_resolve(m_found);
+        }
+    }
+};
+
+template<typename Signal>
+using PromiseFromSignal = typename QtPromise::QPromise<typename PromiseSignal<Signal>::Type>;
+
+// Disconnects all signals then settles the promise with the value (or reason) of the signal.
+template<typename F>
+struct PromiseSignalSettle
+{
+    QtPromise::QPromiseConnections connections;
+    F settle;
+
+    template<typename... V>
+    void operator()(V&&... value) const
+    {
         connections.disconnect();
-        reject(QtPromise::QPromiseUndefinedException{});
-    });
-}
+        settle(std::forward<V>(value)...);
+    }
+};
 
 // Connect signal(args...) to QPromiseResolve
 template<typename T, typename Sender, typename Signal>
-typename std::enable_if<(ArgsOf<Signal>::count >= 1)>::type
-connectSignalToResolver(const QtPromise::QPromiseConnections& connections,
-                        const QtPromise::QPromiseResolve<T>& resolve,
-                        const Sender* sender,
-                        Signal signal)
+void connectSignalToResolver(const QtPromise::QPromiseConnections& connections,
+                             const QtPromise::QPromiseResolve<T>& resolve,
+                             const Sender* sender,
+                             Signal signal)
 {
-    connections << QObject::connect(sender, signal, [=](const T& value) {
-        connections.disconnect();
-        resolve(value);
-    });
+    using Settle = PromiseSignalSettle<QtPromise::QPromiseResolve<T>>;
+    connections << PromiseSignal<Signal>::connect(sender, signal, Settle{connections, resolve});
 }
 
-// Connect signal(args...) to QPromiseReject
+// Connect signal(args...) to QPromiseReject (signal() rejects with QPromiseUndefinedException)
 template<typename T, typename Sender, typename Signal>
-typename std::enable_if<(ArgsOf<Signal>::count >= 1)>::type
-connectSignalToResolver(const QtPromise::QPromiseConnections& connections,
-                        const QtPromise::QPromiseReject<T>& reject,
-                        const Sender* sender,
-                        Signal signal)
+void connectSignalToResolver(const QtPromise::QPromiseConnections& connections,
+                             const QtPromise::QPromiseReject<T>& reject,
+                             const Sender* sender,
+                             Signal signal)
 {
-    using V = Unqualified<typename ArgsOf<Signal>::first>;
-    connections << QObject::connect(sender, signal, [=](const V& value) {
-        connections.disconnect();
-        reject(value);
-    });
+    using Settle = PromiseSignalSettle<QtPromise::QPromiseReject<T>>;
+    connections << PromiseSignal<Signal>::connectReason(sender, signal, Settle{connections, reject});
 }
 
 // Connect QObject::destroyed signal to QPromiseReject
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef QTPROMISE_QPROMISEOUTCOME_H
+#define QTPROMISE_QPROMISEOUTCOME_H
+
+#include "qpromise_p.h"
+
+#include <exception>
+
+namespace QtPromise {
+
+template<typename T>
+class QPromiseOutcome
+{
+public:
+    QPromiseOutcome() { }
+
+    static QPromiseOutcome fulfilled(const T& value)
+    {
+        QPromiseOutcome outcome;
+        outcome.m_value = QtPromisePrivate::PromiseValue<T>{value};
+        return outcome;
+    }
+
+    static QPromiseOutcome rejected(const std::exception_ptr& error)
+    {
+        QPromiseOutcome outcome;
+        outcome.m_error = error;
+        return outcome;
+    }
+
+    bool isFulfilled() const { return !m_value.isNull(); }
+    bool isRejected() const { return m_error != nullptr; }
+
+    // Only valid if the outcome is fulfilled.
+    const T& value() const
+    {
+        Q_ASSERT(isFulfilled());
+        return m_value.data();
+    }
+
+    std::exception_ptr error() const { return m_error; }
+
+private:
+    QtPromisePrivate::PromiseValue<T> m_value;
+    std::exception_ptr m_error;
+};
+
+template<>
+class QPromiseOutcome<void>
+{
+public:
+    QPromiseOutcome() { }
+
+    static QPromiseOutcome fulfilled()
+    {
+        QPromiseOutcome outcome;
+        outcome.m_fulfilled = true;
+        return outcome;
+    }
+
+    static QPromiseOutcome rejected(const std::exception_ptr& error)
+    {
+        QPromiseOutcome outcome;
+        outcome.m_error = error;
+        return outcome;
+    }
+
+    bool isFulfilled() const { return m_fulfilled; }
+    bool isRejected() const { return m_error != nullptr; }
+
+    std::exception_ptr error() const { return m_error; }
+
+private:
+    std::exception_ptr m_error;
+    bool m_fulfilled = false;
+};
+
+} // namespace QtPromise
+
+#endif // QTPROMISE_QPROMISEOUTCOME_H
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef QTPROMISE_QPROMISEPROGRESS_P_H
+#define QTPROMISE_QPROMISEPROGRESS_P_H
+
+#include "qpromise_p.h"
+#include "qpromisetimer_p.h"
+
+#include <mutex>
+
+namespace QtPromisePrivate {
+
+// Progress listener (see PromiseDataBase::addProgress) calling `fn` in the thread which
+// registered it with the progress reported from any thread. Updates are coalesced, the
+// last one winning: at most one delivery is pending at a time, thus at most one update per
+// event loop iteration crosses threads, and deliveries are at least `interval` milliseconds
+// apart if positive. Updates not delivered yet when the promise is settled are dropped.
+class PromiseProgress
+{
+public:
+    PromiseProgress(std::function<void(int, int)> fn, int interval) : m_d{std::make_shared<Data>()}
+    {
+        m_d->fn = std::move(fn);
+        m_d->interval = interval;
+        m_d->thread = QThread::currentThread();
+    }
+
+    void operator()(int value, int maximum) const
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_d->mutex};
+            if (m_d->closed) {
+                return;
+            }
+
+            m_d->value = value;
+            m_d->maximum = maximum;
+            if (m_d->pending) {
+                return;
+            }
+
+            m_d->pending = true;
+        }
+
+        auto data = m_d;
+        qtpromise_defer(
+            [=]() {
+                schedule(data);
+            },
+            data->thread);
+    }
+
+    // Called from the settling thread, before notifying the promise handlers.
+    void close() const
+    {
+        std::lock_guard<std::mutex> lock{m_d->mutex};
+        m_d->closed = true;
+    }
+
+private:
+    struct Data
+    {
+        std::mutex mutex;
+        std::function<void(int, int)> fn;
+        QPointer<QThread> thread;
+        PromiseTimer timer;
+        qint64 last = -1;
+        int interval = 0;
+        int value = 0;
+        int maximum = 0;
+        bool pending = false;
+        bool closed = false;
+    };
+
+    std::shared_ptr<Data> m_d;
+
+    // Called from the listener thread.
+    static void schedule(const std::shared_ptr<Data>& data)
+    {
+        if (data->interval > 0 && data->last >= 0) {
+            const qint64 remaining = data->last + data->interval - PromiseTimer::now();
+            if (remaining > 0) {
+                std::weak_ptr<Data> weak = data;
+                data->timer = PromiseTimer::start(static_cast<int>(remaining), [=]() {
+                    if (auto locked = weak.lock()) {
+                        deliver(locked);
+                    }
+                });
+                return;
+            }
+        }
+
+        deliver(data);
+    }
+
+    static void deliver(const std::shared_ptr<Data>& data)
+    {
+        int value = 0;
+        int maximum = 0;
+        {
+            std::lock_guard<std::mutex> lock{data->mutex};
+            if (data->closed) {
+                return;
+            }
+
+            value = data->value;
+            maximum = data->maximum;
+            data->pending = false;
+        }
+
+        if (data->interval > 0) {
+            data->last = PromiseTimer::now();
+        }
+
+        try {
+            data->fn(value, maximum);
+        } catch (...) {
+            // Progress handlers have no output promise to reject.
+        }
+    }
+};
+
+} // namespace QtPromisePrivate
+
+#endif // QTPROMISE_QPROMISEPROGRESS_P_H
@@ -21,12 +21,18 @@ class QPromise;
 
 namespace QtPromisePrivate {
 
+template<typename T>
+class PromiseData;
+
+struct PromiseInspect;
+
 template<typename T>
 class PromiseResolver
 {
 public:
     PromiseResolver(QtPromise::QPromise<T> promise) : m_d{new Data{}}
     {
+        m_d->state = promise.m_d;
         m_d->promise = new QtPromise::QPromise<T>{std::move(promise)};
     }
 
@@ -76,10 +82,29 @@ public:
         }
     }
 
+    // The following methods may be called from any thread, including while the promise is
+    // being settled (which releases `promise`), so they only access the (immutable) `state`.
+
+    template<typename F>
+    void onCancel(F&& canceler)
+    {
+        m_d->state->addCanceler(std::forward<F>(canceler));
+    }
+
+    // Ignored once the promise is settled.
+    void progress(int value, int maximum) { m_d->state->progress(value, maximum); }
+
+    template<typename F>
+    void onProgressRequested(F&& source)
+    {
+        m_d->state->setProgressSource(std::forward<F>(source));
+    }
+
 private:
     struct Data : public QSharedData
     {
         QtPromise::QPromise<T>* promise = nullptr;
+        QExplicitlySharedDataPointer<PromiseData<T>> state;
     };
 
     QExplicitlySharedDataPointer<Data> m_d;
@@ -113,6 +138,8 @@ public:
     void operator()() const { m_resolver.resolve(); }
 
 private:
+    friend struct QtPromisePrivate::PromiseInspect;
+
     mutable QtPromisePrivate::PromiseResolver<T> m_resolver;
 };
 
@@ -132,6 +159,24 @@ public:
     void operator()() const { m_resolver.reject(); }
 
 private:
+    friend struct QtPromisePrivate::PromiseInspect;
+
+    mutable QtPromisePrivate::PromiseResolver<T> m_resolver;
+};
+
+template<class T>
+class QPromiseProgress
+{
+public:
+    QPromiseProgress(QtPromisePrivate::PromiseResolver<T> resolver)
+        : m_resolver{std::move(resolver)}
+    { }
+
+    void operator()(int value, int maximum) const { m_resolver.progress(value, maximum); }
+
+private:
+    friend struct QtPromisePrivate::PromiseInspect;
+
     mutable QtPromisePrivate::PromiseResolver<T> m_resolver;
 };
 
@@ -0,0 +1,737 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef QTPROMISE_QPROMISESIGNAL_H
+#define QTPROMISE_QPROMISESIGNAL_H
+
+#include "qpromise.h"
+#include "qpromiseconnections.h"
+#include "qpromisetimer_p.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace QtPromisePrivate {
+
+// Private signals (i.e. declared with a trailing QPrivateSignal argument) can't be emitted
+// outside of their class. QPrivateSignal is declared private by Q_OBJECT, but its injected
+// class name is public, which allows to detect it (the argument is then ignored).
+template<typename T, typename Enabled = void>
+struct PromiseIsPrivateSignal : public std::false_type
+{ };
+
+template<typename T>
+struct PromiseIsPrivateSignal<
+    T,
+    typename std::enable_if<std::is_class<class T::QPrivateSignal>::value>::type>
+    : public std::true_type
+{ };
+
+// Unqualified argument types (Types) of a signal, without the trailing QPrivateSignal.
+template<typename Out, typename... In>
+struct PromiseSignalFilter;
+
+template<typename... Out>
+struct PromiseSignalFilter<std::tuple<Out...>>
+{
+    using Types = std::tuple<Out...>;
+};
+
+template<typename... Out, typename Last>
+struct PromiseSignalFilter<std::tuple<Out...>, Last>
+{
+    using Types = typename std::conditional<PromiseIsPrivateSignal<Unqualified<Last>>::value,
+                                            std::tuple<Out...>,
+                                            std::tuple<Out..., Unqualified<Last>>>::type;
+};
+
+template<typename... Out, typename Head, typename Next, typename... Tail>
+struct PromiseSignalFilter<std::tuple<Out...>, Head, Next, Tail...>
+    : public PromiseSignalFilter<std::tuple<Out..., Unqualified<Head>>, Next, Tail...>
+{ };
+
+template<typename Args>
+struct PromiseSignalTypes;
+
+template<typename... Args>
+struct PromiseSignalTypes<std::tuple<Args...>> : public PromiseSignalFilter<std::tuple<>, Args...>
+{ };
+
+// Slot calling `fn` with the value of the signal (see PromiseSignal::Type): the arguments
+// of a multi-argument signal are copied once, in a std::tuple which is then moved to `fn`.
+template<typename Types, typename F>
+struct PromiseSignalSlot;
+
+template<typename... Args, typename F>
+struct PromiseSignalSlot<std::tuple<Args...>, F>
+{
+    using Type = std::tuple<Args...>;
+
+    F fn;
+
+    void operator()(const Args&... args) const { fn(Type{args...}); }
+};
+
+template<typename Arg, typename F>
+struct PromiseSignalSlot<std::tuple<Arg>, F>
+{
+    using Type = Arg;
+
+    F fn;
+
+    void operator()(const Arg& arg) const { fn(arg); }
+};
+
+template<typename F>
+struct PromiseSignalSlot<std::tuple<>, F>
+{
+    using Type = void;
+
+    F fn;
+
+    void operator()() const { fn(); }
+};
+
+// Argument types of the rejection reason of a signal (see connectSignalToResolver), which
+// is only its first argument.
+template<typename Args>
+struct PromiseSignalReason
+{
+    using Types = std::tuple<>;
+};
+
+template<typename Arg, typename... Args>
+struct PromiseSignalReason<std::tuple<Arg, Args...>>
+{
+    using Types = std::tuple<Arg>;
+};
+
+// Value of a signal: void if the signal has no argument, the argument if only one, else a
+// std::tuple of all arguments.
+template<typename Signal>
+struct PromiseSignal
+{
+    using Types = typename PromiseSignalTypes<typename ArgsOf<Signal>::types>::Types;
+    using Type = typename PromiseSignalSlot<Types, void (*)()>::Type;
+
+    template<typename Sender, typename F>
+    static QMetaObject::Connection connect(const Sender* sender, Signal signal, F fn)
+    {
+        return QObject::connect(sender, signal, PromiseSignalSlot<Types, F>{std::move(fn)});
+    }
+
+    template<typename Sender, typename F>
+    static QMetaObject::Connection connectReason(const Sender* sender, Signal signal, F fn)
+    {
+        using ReasonTypes = typename PromiseSignalReason<Types>::Types;
+        return QObject::connect(sender, signal, PromiseSignalSlot<ReasonTypes, F>{std::move(fn)});
+    }
+};
+
+// Emissions awaited by QPromiseSignal::next(count): the values are accumulated in place,
+// in a vector allocated once for the whole batch.
+template<typename T>
+struct PromiseSignalBatch
+{
+    using Type = QVector<T>;
+
+    PromiseResolver<Type> resolver;
+    QVector<T> values;
+    int remaining;
+
+    PromiseSignalBatch(const PromiseResolver<Type>& r, int count) : resolver{r}, remaining{count}
+    {
+        values.reserve(count);
+    }
+
+    void append(const T& value) { values.append(value); }
+    void resolve() { resolver.resolve(std::move(values)); }
+};
+
+template<>
+struct PromiseSignalBatch<void>
+{
+    using Type = void;
+
+    PromiseResolver<void> resolver;
+    int remaining;
+
+    PromiseSignalBatch(const PromiseResolver<void>& r, int count) : resolver{r}, remaining{count} { }
+
+    void append() { }
+    void resolve() { resolver.resolve(); }
+};
+
+// Continuous consumer of the emissions of a QPromiseSignal (e.g. QPromiseSignal::buffer),
+// notified synchronously from the emitting thread until done or the source is closed.
+template<typename T>
+class PromiseSignalObserver
+{
+public:
+    virtual ~PromiseSignalObserver() { }
+    virtual void emitted(const T& value) = 0;
+    virtual void closed(const PromiseError& error) = 0;
+
+    bool isDone() const { return m_done; }
+
+protected:
+    bool m_done = false;
+};
+
+template<>
+class PromiseSignalObserver<void>
+{
+public:
+    virtual ~PromiseSignalObserver() { }
+    virtual void emitted() = 0;
+    virtual void closed(const PromiseError& error) = 0;
+
+    bool isDone() const { return m_done; }
+
+protected:
+    bool m_done = false;
+};
+
+// Shared state of QPromiseSignal: the resolvers of the pending next() promises are simply
+// queued until the next emission(s), the signal connection being kept open.
+template<typename T>
+class PromiseSignalData
+{
+public:
+    using Batch = PromiseSignalBatch<T>;
+    using Observer = PromiseSignalObserver<T>;
+
+    ~PromiseSignalData() { close(QtPromise::QPromiseCanceledException{}); }
+
+    bool isActive() const { return m_active; }
+    const PromiseError& error() const { return m_error; }
+
+    void connect(QMetaObject::Connection&& connection) { m_connections << std::move(connection); }
+
+    // Keeps `upstream` alive as long as this source (see QPromiseSignal::scan).
+    void setUpstream(std::shared_ptr<void> upstream) { m_upstream = std::move(upstream); }
+
+    void observe(std::shared_ptr<Observer> observer) { m_observers.push_back(std::move(observer)); }
+
+    void wait(const PromiseResolver<T>& resolver) { m_waiters.push_back(resolver); }
+    void wait(const PromiseResolver<typename Batch::Type>& resolver, int count)
+    {
+        m_batches.push_back(Batch{resolver, count});
+    }
+
+    template<typename... V>
+    void emitted(const V&... value)
+    {
+        // Promises awaited from the continuations of this emission wait for the next one.
+        std::vector<PromiseResolver<T>> waiters;
+        std::swap(waiters, m_waiters);
+
+        // Completed batches are moved out, the others compacted in place (order preserved).
+        std::vector<Batch> batches;
+        auto kept = m_batches.begin();
+        for (auto it = m_batches.begin(); it != m_batches.end(); ++it) {
+            it->append(value...);
+            if (--it->remaining == 0) {
+                batches.push_back(std::move(*it));
+            } else {
+                if (kept != it) {
+                    *kept = std::move(*it);
+                }
+                ++kept;
+            }
+        }
+        m_batches.erase(kept, m_batches.end());
+
+        for (auto& waiter : waiters) {
+            waiter.resolve(value...);
+        }
+        for (auto& batch : batches) {
+            batch.resolve();
+        }
+
+        if (!m_observers.empty()) {
+            notify(value...);
+        }
+    }
+
+    template<typename E>
+    void close(E&& error)
+    {
+        if (!m_active) {
+            return;
+        }
+
+        m_active = false;
+        m_error = PromiseError{std::forward<E>(error)};
+        m_connections.disconnect();
+
+        std::vector<PromiseResolver<T>> waiters;
+        std::vector<Batch> batches;
+        std::swap(waiters, m_waiters);
+        std::swap(batches, m_batches);
+
+        std::vector<std::shared_ptr<Observer>> observers;
+        std::swap(observers, m_observers);
+
+        for (auto& waiter : waiters) {
+            waiter.reject(m_error);
+        }
+        for (auto& batch : batches) {
+            batch.resolver.reject(m_error);
+        }
+        for (const auto& observer : observers) {
+            if (!observer->isDone()) {
+                observer->closed(m_error);
+            }
+        }
+
+        m_upstream.reset();
+    }
+
+private:
+    std::shared_ptr<void> m_upstream;
+    std::vector<std::shared_ptr<Observer>> m_observers;
+    QtPromise::QPromiseConnections m_connections;
+    std::vector<PromiseResolver<T>> m_waiters;
+    std::vector<Batch> m_batches;
+    PromiseError m_error;
+    bool m_active = true;
+
+    template<typename... V>
+    void notify(const V&... value)
+    {
+        // Observers added meanwhile are notified from the next emission, and none once closed
+        // (the observers are then released by close). Done observers are removed afterward.
+        const auto count = m_observers.size();
+        for (std::size_t i = 0; i < count && m_active; ++i) {
+            const auto observer = m_observers[i];
+            if (!observer->isDone()) {
+                observer->emitted(value...);
+            }
+        }
+
+        m_observers.erase(std::remove_if(m_observers.begin(),
+                                         m_observers.end(),
+                                         [](const std::shared_ptr<Observer>& observer) {
+                                             return observer->isDone();
+                                         }),
+                          m_observers.end());
+    }
+};
+
+// Signal slot forwarding the emissions to the source (not owned, see QPromiseSignal).
+template<typename T>
+struct PromiseSignalEmitted
+{
+    std::weak_ptr<PromiseSignalData<T>> source;
+
+    template<typename... V>
+    void operator()(const V&... value) const
+    {
+        if (auto data = source.lock()) {
+            data->emitted(value...);
+        }
+    }
+};
+
+template<typename T>
+struct PromiseSignalDestroyed
+{
+    std::weak_ptr<PromiseSignalData<T>> source;
+
+    void operator()() const
+    {
+        if (auto data = source.lock()) {
+            data->close(QtPromise::QPromiseContextException{});
+        }
+    }
+};
+
+// Base of the QPromiseSignal operators calling a handler (e.g. QPromiseSignal::buffer): the
+// operator promise is rejected when the source is closed (with the same reason), or as soon
+// as the handler throws, in which case the operator stops observing the source.
+template<typename T>
+class PromiseSignalOperator : public PromiseSignalObserver<T>
+{
+public:
+    explicit PromiseSignalOperator(const PromiseResolver<void>& resolver) : m_resolver{resolver} { }
+
+    void start() { }
+
+    void closed(const PromiseError& error) override
+    {
+        flush();
+        settle(error);
+    }
+
+protected:
+    PromiseTimer m_timer;
+
+    // Delivers the pending values, if any (e.g. the last partial batch when closed).
+    virtual void flush() { }
+
+    template<typename F, typename... V>
+    void call(const F& fn, V&&... value)
+    {
+        try {
+            fn(std::forward<V>(value)...);
+        } catch (...) {
+            settle(std::current_exception());
+        }
+    }
+
+    template<typename E>
+    void settle(E&& error)
+    {
+        this->m_done = true;
+        m_timer.stop();
+        m_resolver.reject(std::forward<E>(error));
+    }
+
+private:
+    PromiseResolver<void> m_resolver;
+};
+
+// Implementation of QPromiseSignal::buffer: values are accumulated in a vector reserved for
+// the size of the previous batch, thus allocated once per batch, and delivered when `count`
+// values are buffered or `msec` milliseconds after the first one, whichever comes first.
+template<typename T, typename F>
+class PromiseSignalBuffer : public PromiseSignalOperator<T>,
+                            public std::enable_shared_from_this<PromiseSignalBuffer<T, F>>
+{
+public:
+    PromiseSignalBuffer(const PromiseResolver<void>& resolver, F fn, int count, int msec)
+        : PromiseSignalOperator<T>{resolver}
+        , m_fn(std::move(fn))
+        , m_count{count}
+        , m_msec{msec}
+        , m_capacity{qMax(count, 1)}
+    { }
+
+    void emitted(const T& value) override
+    {
+        if (m_values.isEmpty()) {
+            m_values.reserve(m_capacity);
+            if (m_msec > 0) {
+                std::weak_ptr<PromiseSignalBuffer<T, F>> weak = this->shared_from_this();
+                this->m_timer = PromiseTimer::start(m_msec, [=]() {
+                    if (auto self = weak.lock()) {
+                        self->flush();
+                    }
+                });
+            }
+        }
+
+        m_values.append(value);
+        if (m_count > 0 && m_values.size() >= m_count) {
+            flush();
+        }
+    }
+
+protected:
+    void flush() override
+    {
+        this->m_timer.stop();
+        if (this->m_done || m_values.isEmpty()) {
+            return;
+        }
+
+        QVector<T> values;
+        std::swap(values, m_values);
+        m_capacity = m_count > 0 ? m_count : static_cast<int>(values.size());
+        this->call(m_fn, std::move(values));
+    }
+
+private:
+    F m_fn;
+    QVector<T> m_values;
+    int m_count;
+    int m_msec;
+    int m_capacity;
+};
+
+// Implementation of QPromiseSignal::window: the last `count` values are kept in a ring
+// buffer, copied in a new vector for each window (every `skip` values once full).
+template<typename T, typename F>
+class PromiseSignalWindow : public PromiseSignalOperator<T>
+{
+public:
+    PromiseSignalWindow(const PromiseResolver<void>& resolver, F fn, int count, int skip)
+        : PromiseSignalOperator<T>{resolver}
+        , m_fn(std::move(fn))
+        , m_count{qMax(count, 1)}
+        , m_skip{qMax(skip, 1)}
+        , m_remaining{m_count}
+    {
+        m_ring.reserve(m_count);
+    }
+
+    void emitted(const T& value) override
+    {
+        if (m_ring.size() < m_count) {
+            m_ring.append(value);
+        } else {
+            m_ring[m_head] = value;
+            m_head = (m_head + 1) % m_count;
+        }
+
+        if (--m_remaining > 0) {
+            return;
+        }
+
+        QVector<T> window;
+        window.reserve(m_count);
+        for (int i = 0; i < m_count; ++i) {
+            window.append(m_ring.at((m_head + i) % m_count));
+        }
+
+        m_remaining = m_skip;
+        this->call(m_fn, std::move(window));
+    }
+
+private:
+    F m_fn;
+    QVector<T> m_ring;
+    int m_count;
+    int m_skip;
+    int m_remaining;
+    int m_head = 0;
+};
+
+// Implementation of QPromiseSignal::sample: only the latest value is kept (assigned in
+// place) and delivered every `msec` milliseconds, if any value has been emitted meanwhile.
+template<typename T, typename F>
+class PromiseSignalSample : public PromiseSignalOperator<T>,
+                            public std::enable_shared_from_this<PromiseSignalSample<T, F>>
+{
+public:
+    PromiseSignalSample(const PromiseResolver<void>& resolver, F fn, int msec)
+        : PromiseSignalOperator<T>{resolver}, m_fn(std::move(fn)), m_msec{qMax(msec, 1)}
+    { }
+
+    void start() { schedule(); }
+
+    void emitted(const T& value) override
+    {
+        m_value = value;
+        m_pending = true;
+    }
+
+protected:
+    void flush() override
+    {
+        if (!this->m_done && m_pending) {
+            m_pending = false;
+            this->call(m_fn, static_cast<const T&>(m_value));
+        }
+    }
+
+private:
+    F m_fn;
+    T m_value{};
+    int m_msec;
+    bool m_pending = false;
+
+    void schedule()
+    {
+        std::weak_ptr<PromiseSignalSample<T, F>> weak = this->shared_from_this();
+        this->m_timer = PromiseTimer::start(m_msec, [=]() {
+            if (auto self = weak.lock()) {
+                self->flush();
+                if (!self->m_done) {
+                    self->schedule();
+                }
+            }
+        });
+    }
+};
+
+// Implementation of QPromiseSignal::scan: emits the accumulated value to the `target` source,
+// which is closed if `reducer` throws (the upstream source is then not observed anymore).
+template<typename T, typename R, typename F>
+class PromiseSignalScan : public PromiseSignalObserver<T>
+{
+public:
+    PromiseSignalScan(const std::shared_ptr<PromiseSignalData<R>>& target, F reducer, R initial)
+        : m_target{target}, m_reducer(std::move(reducer)), m_value(std::move(initial))
+    { }
+
+    void emitted(const T& value) override
+    {
+        auto target = m_target.lock();
+        if (!target || !target->isActive()) {
+            this->m_done = true;
+            return;
+        }
+
+        try {
+            m_value = m_reducer(m_value, value);
+        } catch (...) {
+            this->m_done = true;
+            target->close(std::current_exception());
+            return;
+        }
+
+        target->emitted(m_value);
+    }
+
+    void closed(const PromiseError& error) override
+    {
+        this->m_done = true;
+        if (auto target = m_target.lock()) {
+            target->close(error);
+        }
+    }
+
+private:
+    std::weak_ptr<PromiseSignalData<R>> m_target;
+    F m_reducer;
+    R m_value;
+};
+
+} // namespace QtPromisePrivate
+
+namespace QtPromise {
+
+template<typename T>
+class QPromiseSignal
+{
+public:
+    using Batch = typename QtPromisePrivate::PromiseSignalBatch<T>::Type;
+
+    template<typename Sender, typename Signal>
+    QPromiseSignal(const Sender* sender, Signal signal)
+        : m_d(std::make_shared<QtPromisePrivate::PromiseSignalData<T>>())
+    {
+        using namespace QtPromisePrivate;
+
+        m_d->connect(PromiseSignal<Signal>::connect(sender, signal, PromiseSignalEmitted<T>{m_d}));
+        m_d->connect(
+            QObject::connect(sender, &QObject::destroyed, PromiseSignalDestroyed<T>{m_d}));
+    }
+
+    bool isActive() const { return m_d->isActive(); }
+
+    QPromise<T> next() const
+    {
+        auto d = m_d;
+        return QPromise<T>{[&](const QPromiseResolve<T>& resolve, const QPromiseReject<T>& reject) {
+            if (d->isActive()) {
+                d->wait(QtPromisePrivate::PromiseInspect::resolver(resolve));
+            } else {
+                reject(d->error());
+            }
+        }};
+    }
+
+    QPromise<Batch> next(int count) const
+    {
+        auto d = m_d;
+        return QPromise<Batch>{
+            [&](const QPromiseResolve<Batch>& resolve, const QPromiseReject<Batch>& reject) {
+                if (!d->isActive()) {
+                    reject(d->error());
+                } else if (count <= 0) {
+                    QtPromisePrivate::PromiseSignalBatch<T>{
+                        QtPromisePrivate::PromiseInspect::resolver(resolve),
+                        0}
+                        .resolve();
+                } else {
+                    d->wait(QtPromisePrivate::PromiseInspect::resolver(resolve), count);
+                }
+            }};
+    }
+
+    template<typename F>
+    QPromise<void> buffer(int count, int msec, F handler) const
+    {
+        return observe<QtPromisePrivate::PromiseSignalBuffer<T, F>>(std::move(handler),
+                                                                     count,
+                                                                     msec);
+    }
+
+    template<typename F>
+    QPromise<void> buffer(int count, std::chrono::milliseconds msec, F handler) const
+    {
+        return buffer(count, static_cast<int>(msec.count()), std::move(handler));
+    }
+
+    template<typename F>
+    QPromise<void> window(int count, int skip, F handler) const
+    {
+        return observe<QtPromisePrivate::PromiseSignalWindow<T, F>>(std::move(handler),
+                                                                     count,
+                                                                     skip);
+    }
+
+    template<typename F>
+    QPromise<void> sample(int msec, F handler) const
+    {
+        return observe<QtPromisePrivate::PromiseSignalSample<T, F>>(std::move(handler), msec);
+    }
+
+    template<typename F>
+    QPromise<void> sample(std::chrono::milliseconds msec, F handler) const
+    {
+        return sample(static_cast<int>(msec.count()), std::move(handler));
+    }
+
+    template<typename R, typename F>
+    QPromiseSignal<R> scan(F reducer, R initial) const
+    {
+        using namespace QtPromisePrivate;
+
+        auto target = std::make_shared<PromiseSignalData<R>>();
+        if (!m_d->isActive()) {
+            target->close(m_d->error());
+        } else {
+            target->setUpstream(m_d);
+            m_d->observe(
+                std::make_shared<PromiseSignalScan<T, R, F>>(target,
+                                                              std::move(reducer),
+                                                              std::move(initial)));
+        }
+
+        return QPromiseSignal<R>{target};
+    }
+
+    void disconnect() const { m_d->close(QPromiseCanceledException{}); }
+
+private:
+    template<typename U>
+    friend class QPromiseSignal;
+
+    std::shared_ptr<QtPromisePrivate::PromiseSignalData<T>> m_d;
+
+    explicit QPromiseSignal(std::shared_ptr<QtPromisePrivate::PromiseSignalData<T>> d)
+        : m_d(std::move(d))
+    { }
+
+    template<typename Operator, typename... Args>
+    QPromise<void> observe(Args&&... args) const
+    {
+        auto d = m_d;
+        return QPromise<void>{[&](const QPromiseResolve<void>&, const QPromiseReject<void>& reject) {
+            if (!d->isActive()) {
+                reject(d->error());
+                return;
+            }
+
+            auto op = std::make_shared<Operator>(QtPromisePrivate::PromiseInspect::resolver(reject),
+                                                 std::forward<Args>(args)...);
+            op->start();
+            d->observe(std::move(op));
+        }};
+    }
+};
+
+} // namespace QtPromise
+
+#endif // QTPROMISE_QPROMISESIGNAL_H
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef QTPROMISE_QPROMISETHREADPOOL_H
+#define QTPROMISE_QPROMISETHREADPOOL_H
+
+#include "qpromiseexecutor.h"
+
+#include <QtCore/QThread>
+#include <QtCore/QThreadStorage>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace QtPromisePrivate {
+
+// Tasks of a pool worker: the worker pushes and pops its own tasks at the back (most recent
+// first, likely still in cache) while the other workers steal the oldest ones at the front.
+class PromiseWorkerQueue
+{
+public:
+    // Returns false (dropping `task`) once the queue has been closed.
+    bool push(std::function<void()> task)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_closed) {
+            return false;
+        }
+
+        m_tasks.push_back(std::move(task));
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_closed = true;
+    }
+
+    bool pop(std::function<void()>& task)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_tasks.empty()) {
+            return false;
+        }
+
+        task = std::move(m_tasks.back());
+        m_tasks.pop_back();
+        return true;
+    }
+
+    bool steal(std::function<void()>& task)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_tasks.empty()) {
+            return false;
+        }
+
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+        return true;
+    }
+
+    int size() const
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        return static_cast<int>(m_tasks.size());
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_closed = false;
+};
+
+} // namespace QtPromisePrivate
+
+namespace QtPromise {
+
+class QPromiseThreadPool
+{
+public:
+    explicit QPromiseThreadPool(int threadCount = QThread::idealThreadCount())
+        : m_d{std::make_shared<Data>(qMax(threadCount, 1))}
+    {
+        for (int i = 0; i < m_d->count; ++i) {
+            m_d->threads.emplace_back(&Data::run, m_d, i);
+        }
+    }
+
+    // Runs the remaining tasks (including the ones they start) then joins the workers. When
+    // destroyed from one of its tasks, the calling worker is detached instead and runs the
+    // remaining tasks once that task returns.
+    ~QPromiseThreadPool() { m_d->shutdown(); }
+
+    int threadCount() const { return m_d->count; }
+
+    // Number of tasks waiting to be run, in the whole pool or in the queue of `worker`.
+    int queueDepth() const
+    {
+        int depth = m_d->injected.size();
+        for (int i = 0; i < m_d->count; ++i) {
+            depth += m_d->worker(i).tasks.size();
+        }
+        return depth;
+    }
+    int queueDepth(int worker) const
+    {
+        return worker >= 0 && worker < m_d->count ? m_d->worker(worker).tasks.size() : 0;
+    }
+
+    // Number of tasks run by another worker than the one they were queued to.
+    qint64 stealCount() const { return m_d->steals; }
+
+    // Tasks started from a worker of this pool are queued to that worker (and will most
+    // likely run there), else to a shared queue served by all the workers. Returns false,
+    // dropping `task`, if the pool is being destroyed (see start()).
+    bool start(std::function<void()> task) const { return m_d->start(std::move(task)); }
+
+    // Executor starting the continuations as tasks of this pool. The ones which can't be
+    // started anymore, once the pool is being destroyed, reject their output promise with
+    // QPromiseCanceledException (see QPromiseExecutor).
+    QPromiseExecutor executor() const
+    {
+        std::weak_ptr<Data> weak = m_d;
+        return QPromiseExecutor{[=](std::function<void()> fn) {
+            auto d = weak.lock();
+            return d && d->start(std::move(fn));
+        }};
+    }
+
+private:
+    struct Worker
+    {
+        QtPromisePrivate::PromiseWorkerQueue tasks;
+
+        // Queue of the worker thread, also receiving the continuations registered without
+        // executor from this thread (see qtpromise_defer): idle workers sleep in this queue.
+        std::shared_ptr<QtPromisePrivate::PromiseQueue> inbox;
+        std::atomic<bool> sleeping{false};
+        std::atomic<bool> ready{false};
+    };
+
+    struct Slot
+    {
+        const void* pool = nullptr;
+        int index = -1;
+    };
+
+    struct Data
+    {
+        QtPromisePrivate::PromiseWorkerQueue injected;
+        std::unique_ptr<Worker[]> workers;
+        std::vector<std::thread> threads;
+        std::atomic<int> idle{0};
+        std::atomic<qint64> steals{0};
+        std::atomic<bool> stopping{false};
+        int count;
+
+        explicit Data(int threadCount) : workers{new Worker[threadCount]}, count{threadCount}
+        {
+            threads.reserve(static_cast<std::size_t>(threadCount));
+        }
+
+        Worker& worker(int index) { return workers[static_cast<std::size_t>(index)]; }
+
+        static Slot& current()
+        {
+            static QThreadStorage<Slot> storage;
+            return storage.localData();
+        }
+
+        bool start(std::function<void()> task)
+        {
+            // Once the pool is being destroyed, only the tasks started by the remaining ones
+            // are accepted: the shared queue is closed *before* `stopping` is set, so the
+            // workers exiting see all the tasks queued to it (see shutdown()).
+            const Slot& slot = current();
+            if (slot.pool == this) {
+                worker(slot.index).tasks.push(std::move(task));
+            } else if (!injected.push(std::move(task))) {
+                return false;
+            }
+
+            // `idle` is only written by the workers parking (and by wakeOne()), so it stays in
+            // the cache of the starting threads as long as the workers are busy.
+            if (idle > 0) {
+                wakeOne(slot.pool == this ? slot.index : 0);
+            }
+
+            return true;
+        }
+
+        void wakeOne(int from)
+        {
+            for (int i = 0; i < count; ++i) {
+                Worker& worker = this->worker((from + i) % count);
+                if (worker.sleeping.exchange(false)) {
+                    --idle;
+                    worker.inbox->wakeUp();
+                    return;
+                }
+            }
+        }
+
+        bool take(int index, std::function<void()>& task)
+        {
+            if (worker(index).tasks.pop(task) || injected.steal(task)) {
+                return true;
+            }
+
+            for (int i = 1; i < count; ++i) {
+                if (worker((index + i) % count).tasks.steal(task)) {
+                    ++steals;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // The workers share the ownership of the data, which outlives the pool if destroyed
+        // from one of its tasks.
+        static void run(std::shared_ptr<Data> d, int index) { d->work(index); }
+
+        void work(int index)
+        {
+            using Clock = QtPromisePrivate::PromiseQueue::Clock;
+
+            Worker& worker = this->worker(index);
+            Slot& slot = current();
+            slot.pool = this;
+            slot.index = index;
+
+            worker.inbox = QtPromisePrivate::PromiseQueue::of(QThread::currentThread());
+            worker.ready = true;
+
+            // The continuations registered from this worker are queued directly to its inbox.
+            QtPromisePrivate::PromiseQueueExecutor::setCurrent(
+                std::make_shared<QtPromisePrivate::PromiseQueueExecutor>(worker.inbox));
+
+            while (true) {
+                std::function<void()> task;
+                if (!take(index, task)) {
+                    if (stopping) {
+                        // The continuations queued to this thread may still start tasks.
+                        if (worker.inbox->run() > 0) {
+                            continue;
+                        }
+                        break;
+                    }
+
+                    // Checking the queues again *after* publishing the idle state guarantees
+                    // that start() either sees this worker sleeping (and wakes it up), or that
+                    // the task it queued is taken here (both access the queue under its lock).
+                    worker.sleeping = true;
+                    ++idle;
+
+                    const bool found = take(index, task);
+                    if (!found && !stopping) {
+                        worker.inbox->wait(Clock::time_point::max());
+                    }
+
+                    if (worker.sleeping.exchange(false)) {
+                        --idle;
+                    }
+
+                    if (!found) {
+                        continue;
+                    }
+                }
+
+                task();
+                task = nullptr;
+                worker.inbox->run();
+            }
+
+            QtPromisePrivate::PromiseQueueExecutor::setCurrent(nullptr);
+            slot = Slot{};
+        }
+
+        void shutdown()
+        {
+            injected.close();
+            stopping = true;
+            for (int i = 0; i < count; ++i) {
+                // The worker may not have created its inbox yet, in which case it will see
+                // `stopping` before sleeping.
+                Worker& worker = this->worker(i);
+                if (worker.ready) {
+                    worker.inbox->wakeUp();
+                }
+            }
+
+            for (auto& thread : threads) {
+                if (thread.get_id() == std::this_thread::get_id()) {
+                    // Destroyed from one of its tasks: this worker can't join itself.
+                    Q_ASSERT(current().pool == this);
+                    thread.detach();
+                } else {
+                    thread.join();
+                }
+            }
+        }
+    };
+
+    std::shared_ptr<Data> m_d;
+
+    Q_DISABLE_COPY(QPromiseThreadPool)
+};
+
+} // namespace QtPromise
+
+#endif // QTPROMISE_QPROMISETHREADPOOL_H
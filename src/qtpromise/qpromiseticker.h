@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef QTPROMISE_QPROMISETICKER_H
+#define QTPROMISE_QPROMISETICKER_H
+
+#include "qpromise.h"
+#include "qpromisetimer_p.h"
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace QtPromise {
+
+class QPromiseTicker
+{
+public:
+    explicit QPromiseTicker(int msec) : m_d(std::make_shared<Data>(msec))
+    {
+        Data::schedule(m_d);
+    }
+
+    explicit QPromiseTicker(std::chrono::milliseconds msec)
+        : QPromiseTicker(static_cast<int>(msec.count()))
+    { }
+
+    int interval() const { return m_d->interval; }
+    bool isActive() const { return m_d->active; }
+
+    QPromise<int> next() const
+    {
+        auto d = m_d;
+        return QPromise<int>{[&](const QPromiseResolve<int>& resolve,
+                                 const QPromiseReject<int>& reject) {
+            if (d->pending > 0) {
+                resolve(d->take());
+            } else if (!d->active) {
+                reject(QPromiseCanceledException{});
+            } else {
+                d->waiters.push_back(QtPromisePrivate::PromiseInspect::resolver(resolve));
+            }
+        }};
+    }
+
+    void stop() const { m_d->stop(); }
+
+private:
+    struct Data
+    {
+        QtPromisePrivate::PromiseTimer timer;
+        std::vector<QtPromisePrivate::PromiseResolver<int>> waiters;
+        qint64 origin;
+        qint64 index = 0;
+        qint64 pending = 0;
+        int interval;
+        bool active = true;
+
+        explicit Data(int msec)
+            : origin(QtPromisePrivate::PromiseTimer::now()), interval(qMax(msec, 1))
+        { }
+
+        ~Data() { stop(); }
+
+        int take()
+        {
+            const auto count = static_cast<int>(qMin(pending, qint64(INT_MAX)));
+            pending = 0;
+            return count;
+        }
+
+        void stop()
+        {
+            std::vector<QtPromisePrivate::PromiseResolver<int>> resolvers;
+
+            timer.stop();
+            active = false;
+            pending = 0;
+            std::swap(resolvers, waiters);
+
+            for (auto& resolver : resolvers) {
+                resolver.reject(QPromiseCanceledException{});
+            }
+        }
+
+        // Ticks are scheduled relative to the ticker creation (origin) so that the
+        // latency of the previous ticks doesn't accumulate (drift compensation).
+        static void schedule(const std::shared_ptr<Data>& d)
+        {
+            std::weak_ptr<Data> weak = d;
+            const qint64 deadline = d->origin + (d->index + 1) * d->interval;
+            const qint64 msec = deadline - QtPromisePrivate::PromiseTimer::now();
+
+            d->timer = QtPromisePrivate::PromiseTimer::start(static_cast<int>(msec), [=]() {
+                if (auto ticker = weak.lock()) {
+                    tick(ticker);
+                }
+            });
+        }
+
+        static void tick(const std::shared_ptr<Data>& d)
+        {
+            // Ticks missed because of a busy event loop are coalesced into this one.
+            const qint64 index = (QtPromisePrivate::PromiseTimer::now() - d->origin) / d->interval;
+            d->pending += qMax(index - d->index, qint64(1));
+            d->index = qMax(index, d->index + 1);
+
+            schedule(d);
+
+            if (!d->waiters.empty()) {
+                std::vector<QtPromisePrivate::PromiseResolver<int>> resolvers;
+                std::swap(resolvers, d->waiters);
+
+                const int count = d->take();
+                for (auto& resolver : resolvers) {
+                    resolver.resolve(count);
+                }
+            }
+        }
+    };
+
+    std::shared_ptr<Data> m_d;
+};
+
+} // namespace QtPromise
+
+#endif // QTPROMISE_QPROMISETICKER_H
@@ -0,0 +1,527 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#ifndef QTPROMISE_QPROMISETIMER_P_H
+#define QTPROMISE_QPROMISETIMER_P_H
+
+#include "qpromise_p.h"
+#include "qpromiseclock.h"
+
+#include <QtCore/QBasicTimer>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThreadStorage>
+#include <QtCore/QTimerEvent>
+
+#include <atomic>
+#include <climits>
+#include <vector>
+
+namespace QtPromisePrivate {
+
+class PromiseTimerWheel;
+
+struct PromiseTimerNode
+{
+    // Thread of the wheel in which the node is scheduled, the only one allowed to access
+    // the fields below `active` (other threads can only clear `active`, see PromiseTimer).
+    QPointer<QThread> thread;
+    std::atomic<bool> active{false};
+
+    PromiseTimerWheel* wheel = nullptr;
+    PromiseTimerNode** slot = nullptr;
+    PromiseTimerNode* prev = nullptr;
+    PromiseTimerNode* next = nullptr;
+    qint64 expiry = 0;
+    std::function<void()> callback;
+
+    // Keeps the node alive while scheduled (i.e. linked in the wheel).
+    std::shared_ptr<PromiseTimerNode> self;
+};
+
+// Hierarchical timer wheel (one per thread) shared by all the promise timers created
+// from this thread (e.g. QPromise::timeout, QPromise::delay). Timers are stored in
+// intrusive lists, thus insertion and removal are O(1), and a single Qt timer is armed
+// at the next expiry. Expiries are expressed in milliseconds (ticks) since the wheel
+// creation: level 0 has one slot per tick, each slot of the next levels covers all the
+// slots of the previous level and its timers are cascaded down when reached. Time is
+// provided by the clock installed for the thread (QtPromise::QPromiseClock), if any.
+// A thread without event dispatcher (e.g. std::thread, QPromiseThreadPool workers) can't
+// fire a Qt timer: the next expiry is then set on its continuation queue instead, which
+// expires it while the thread waits for a promise, runs its pending continuations or, for
+// the pool workers, is idle (see PromiseQueue::setTimer).
+class PromiseTimerWheel : public QObject
+{
+public:
+    static PromiseTimerWheel* instance()
+    {
+        static QThreadStorage<PromiseTimerWheel*> storage;
+        if (!storage.hasLocalData()) {
+            storage.setLocalData(new PromiseTimerWheel);
+        }
+
+        return storage.localData();
+    }
+
+    ~PromiseTimerWheel() override
+    {
+        if (m_queue) {
+            m_queue->setTimer({}, nullptr);
+        }
+
+        for (auto& level : m_slots) {
+            for (auto& slot : level) {
+                while (slot) {
+                    auto node = slot;
+                    node->active = false;
+                    unlink(node);
+                    node->self.reset();
+                }
+            }
+        }
+    }
+
+    // Milliseconds elapsed since the wheel creation (system clock).
+    qint64 now() const { return m_clock ? m_clock->now() : m_elapsed.elapsed(); }
+
+    QtPromise::QPromiseClock* clock() const { return m_clock; }
+
+    void setClock(QtPromise::QPromiseClock* clock)
+    {
+        if (clock == m_clock) {
+            return;
+        }
+
+        // Timers pending in the previous clock keep their remaining time.
+        std::vector<PromiseTimerNode*> nodes;
+        for (auto& level : m_slots) {
+            for (auto& slot : level) {
+                for (auto node = slot; node; node = node->next) {
+                    nodes.push_back(node);
+                }
+                slot = nullptr;
+            }
+        }
+
+        const qint64 previous = now();
+
+        disarm();
+        m_clock = clock;
+        m_now = now();
+
+        for (auto node : nodes) {
+            node->expiry = m_now + qMax(node->expiry - previous, qint64(1));
+            link(node);
+        }
+
+        if (m_count > 0) {
+            schedule(next());
+        }
+    }
+
+    void expire()
+    {
+        m_deadline = -1;
+        advance(now());
+
+        if (m_count > 0) {
+            schedule(next());
+        } else {
+            disarm();
+        }
+    }
+
+    void insert(const std::shared_ptr<PromiseTimerNode>& node, int msec)
+    {
+        Q_ASSERT(!node->wheel);
+
+        const qint64 now = this->now();
+        if (m_count == 0) {
+            // Nothing to expire in between, no need to catch up.
+            m_now = now;
+        }
+
+        node->thread = QThread::currentThread();
+        node->active = true;
+        node->wheel = this;
+        node->expiry = qMax(now + qMax(msec, 0), m_now + 1);
+        node->self = node;
+        link(node.get());
+        m_count++;
+
+        schedule(node->expiry);
+    }
+
+    void remove(PromiseTimerNode* node)
+    {
+        Q_ASSERT(node->wheel == this);
+
+        unlink(node);
+        m_count--;
+
+        if (m_count == 0) {
+            disarm();
+        }
+
+        // Must be the last statement since it may delete the node.
+        node->self.reset();
+    }
+
+protected:
+    void timerEvent(QTimerEvent* event) override
+    {
+        if (event->timerId() != m_timer.timerId()) {
+            QObject::timerEvent(event);
+            return;
+        }
+
+        m_timer.stop();
+        expire();
+    }
+
+private:
+    static const int Bits = 6;
+    static const int Slots = 1 << Bits;
+    static const int Levels = 4;
+
+    PromiseTimerNode* m_slots[Levels][Slots] = {};
+    QtPromise::QPromiseClock* m_clock = nullptr;
+    QElapsedTimer m_elapsed;
+    QBasicTimer m_timer;
+    std::shared_ptr<PromiseQueue> m_queue;
+    qint64 m_deadline = -1;
+    qint64 m_now = 0;
+    int m_count = 0;
+
+    PromiseTimerWheel() { m_elapsed.start(); }
+
+    static int indexOf(qint64 tick, int level)
+    {
+        return static_cast<int>((tick >> (level * Bits)) & (Slots - 1));
+    }
+
+    void link(PromiseTimerNode* node)
+    {
+        const qint64 delta = node->expiry - m_now;
+
+        int level = 0;
+        while (level < Levels - 1 && delta >= (qint64(1) << ((level + 1) * Bits))) {
+            level++;
+        }
+
+        // Timers beyond the wheel range are parked in the last slot of the last level
+        // and re-linked (thus moved closer) each time that slot is cascaded.
+        const qint64 tick = qMin(node->expiry, m_now + (qint64(1) << (Levels * Bits)) - 1);
+        auto& head = m_slots[level][indexOf(tick, level)];
+
+        node->slot = &head;
+        node->prev = nullptr;
+        node->next = head;
+        if (head) {
+            head->prev = node;
+        }
+        head = node;
+    }
+
+    void unlink(PromiseTimerNode* node)
+    {
+        if (node->prev) {
+            node->prev->next = node->next;
+        } else {
+            *node->slot = node->next;
+        }
+
+        if (node->next) {
+            node->next->prev = node->prev;
+        }
+
+        node->wheel = nullptr;
+        node->slot = nullptr;
+        node->prev = nullptr;
+        node->next = nullptr;
+    }
+
+    void advance(qint64 now)
+    {
+        while (m_now < now && m_count > 0) {
+            // Skip the ticks without timers to expire or to cascade.
+            m_now = qMin(next(), now);
+
+            // Cascade the timers of the upper level slots reached at this tick.
+            for (int level = 1; level < Levels; ++level) {
+                if (m_now & ((qint64(1) << (level * Bits)) - 1)) {
+                    break;
+                }
+
+                auto node = m_slots[level][indexOf(m_now, level)];
+                m_slots[level][indexOf(m_now, level)] = nullptr;
+                while (node) {
+                    auto next = node->next;
+                    link(node);
+                    node = next;
+                }
+            }
+
+            auto& slot = m_slots[0][indexOf(m_now, 0)];
+            while (slot) {
+                auto node = slot->self;
+                Q_ASSERT(node->expiry <= m_now);
+
+                // The timer may have been stopped from another thread, in which case it
+                // will be removed by the posted stop() but must not be called meanwhile.
+                auto callback = std::move(node->callback);
+                const bool active = node->active.exchange(false);
+                remove(node.get());
+                if (active) {
+                    callback();
+                }
+            }
+        }
+
+        if (m_count == 0) {
+            m_now = now;
+        }
+    }
+
+    // Returns the next tick at which the wheel needs to be advanced, either to
+    // expire timers (level 0) or to cascade timers from upper levels.
+    qint64 next() const
+    {
+        qint64 result = -1;
+        for (int level = 0; level < Levels; ++level) {
+            const int shift = level * Bits;
+            for (int i = 1; i <= Slots; ++i) {
+                const qint64 tick = ((m_now >> shift) + i) << shift;
+                if (m_slots[level][indexOf(tick, level)]) {
+                    if (result == -1 || tick < result) {
+                        result = tick;
+                    }
+                    break;
+                }
+            }
+        }
+
+        Q_ASSERT(result != -1);
+        return result;
+    }
+
+    void schedule(qint64 deadline)
+    {
+        if (m_deadline >= 0 && m_deadline <= deadline) {
+            return;
+        }
+
+        m_deadline = deadline;
+        if (m_clock) {
+            m_clock->schedule(deadline);
+            return;
+        }
+
+        const qint64 msec = qMax(deadline - now(), qint64(0));
+        if (!QAbstractEventDispatcher::instance()) {
+            if (!m_queue) {
+                m_queue = PromiseQueue::of(QThread::currentThread());
+            }
+
+            m_queue->setTimer(PromiseQueue::Clock::now() + std::chrono::milliseconds(msec),
+                              [this]() {
+                                  expire();
+                              });
+            return;
+        }
+
+        // Same timer type as QTimer::singleShot for the given interval.
+        m_timer.start(static_cast<int>(qMin(msec, qint64(INT_MAX))),
+                      msec >= 2000 ? Qt::CoarseTimer : Qt::PreciseTimer,
+                      this);
+    }
+
+    void disarm()
+    {
+        m_deadline = -1;
+        if (m_clock) {
+            m_clock->schedule(-1);
+        } else {
+            m_timer.stop();
+            if (m_queue) {
+                m_queue->setTimer({}, nullptr);
+            }
+        }
+    }
+};
+
+// Handle on a callback scheduled in the timer wheel of the current thread. The callback
+// (and thus everything it captures) is released as soon as it's called or the timer is
+// stopped. A timer can be stopped from any thread: the callback is then guaranteed to not
+// be called anymore, but is only released once the thread in which the timer has been
+// started processes the removal.
+class PromiseTimer
+{
+public:
+    PromiseTimer() { }
+
+    static PromiseTimer start(int msec, std::function<void()> callback)
+    {
+        auto node = std::make_shared<PromiseTimerNode>();
+        node->callback = std::move(callback);
+        PromiseTimerWheel::instance()->insert(node, msec);
+        return PromiseTimer{node};
+    }
+
+    // Current time (in milliseconds) of the timer wheel of the current thread.
+    static qint64 now() { return PromiseTimerWheel::instance()->now(); }
+
+    bool isActive() const
+    {
+        auto node = m_node.lock();
+        return node && node->active;
+    }
+
+    void stop() const
+    {
+        auto node = m_node.lock();
+        if (!node || !node->active.exchange(false)) {
+            return;
+        }
+
+        if (node->thread == QThread::currentThread()) {
+            node->wheel->remove(node.get());
+            return;
+        }
+
+        qtpromise_defer(
+            [node]() {
+                if (node->wheel) {
+                    node->wheel->remove(node.get());
+                }
+            },
+            node->thread);
+    }
+
+private:
+    std::weak_ptr<PromiseTimerNode> m_node;
+
+    PromiseTimer(const std::shared_ptr<PromiseTimerNode>& node) : m_node{node} { }
+};
+
+// Resolve or reject functor which stops the given timer before forwarding the value
+// (or reason) of the promise to `fn` (e.g. QPromise::timeout).
+template<typename F>
+struct PromiseTimerGuard
+{
+    PromiseTimer timer;
+    F fn;
+
+    template<typename... V>
+    void operator()(V&&... value) const
+    {
+        timer.stop();
+        fn(std::forward<V>(value)...);
+    }
+};
+
+template<typename T>
+struct PromiseTimeout
+{
+    template<typename E>
+    static void call(const QtPromise::QPromise<T>& promise,
+                     int msec,
+                     E&& error,
+                     const QtPromise::QPromiseResolve<T>& resolve,
+                     const QtPromise::QPromiseReject<T>& reject)
+    {
+        if (!promise.isPending()) {
+            PromiseFulfill<QtPromise::QPromise<T>>::call(promise, resolve, reject);
+            return;
+        }
+
+        using ErrorType = typename std::decay<E>::type;
+        const ErrorType value{std::forward<E>(error)};
+
+        auto timer = PromiseTimer::start(msec, [=]() {
+            // we don't need to verify the current promise state, reject()
+            // takes care of checking if the promise is already resolved,
+            // and thus will ignore this rejection.
+            reject(value);
+        });
+
+        using ResolveType = PromiseTimerGuard<QtPromise::QPromiseResolve<T>>;
+        using RejectType = PromiseTimerGuard<QtPromise::QPromiseReject<T>>;
+
+        PromiseFulfill<QtPromise::QPromise<T>>::call(promise,
+                                                     ResolveType{timer, resolve},
+                                                     RejectType{timer, reject});
+    }
+};
+
+template<typename T>
+struct PromiseDelay
+{
+    struct Fulfilled
+    {
+        int msec;
+        QtPromise::QPromiseResolve<T> resolve;
+
+        void operator()(const PromiseValue<T>& value) const
+        {
+            const auto fulfill = resolve;
+            PromiseTimer::start(msec, [=]() {
+                fulfill(value);
+            });
+        }
+    };
+
+    static void call(const QtPromise::QPromise<T>& promise,
+                     int msec,
+                     const QtPromise::QPromiseResolve<T>& resolve,
+                     const QtPromise::QPromiseReject<T>& reject)
+    {
+        PromiseFulfill<QtPromise::QPromise<T>>::call(promise, Fulfilled{msec, resolve}, reject);
+    }
+};
+
+template<>
+struct PromiseDelay<void>
+{
+    struct Fulfilled
+    {
+        int msec;
+        QtPromise::QPromiseResolve<void> resolve;
+
+        void operator()() const { PromiseTimer::start(msec, resolve); }
+    };
+
+    static void call(const QtPromise::QPromise<void>& promise,
+                     int msec,
+                     const QtPromise::QPromiseResolve<void>& resolve,
+                     const QtPromise::QPromiseReject<void>& reject)
+    {
+        PromiseFulfill<QtPromise::QPromise<void>>::call(promise, Fulfilled{msec, resolve}, reject);
+    }
+};
+
+} // namespace QtPromisePrivate
+
+namespace QtPromise {
+
+inline QPromiseClock* QPromiseClock::current()
+{
+    return QtPromisePrivate::PromiseTimerWheel::instance()->clock();
+}
+
+inline void QPromiseClock::install(QPromiseClock* clock)
+{
+    QtPromisePrivate::PromiseTimerWheel::instance()->setClock(clock);
+}
+
+inline void QPromiseClock::expire()
+{
+    QtPromisePrivate::PromiseTimerWheel::instance()->expire();
+}
+
+} // namespace QtPromise
+
+#endif // QTPROMISE_QPROMISETIMER_P_H
@@ -16,9 +16,11 @@ class tst_exceptions : public QObject
     Q_OBJECT
 
 private Q_SLOTS:
+    void aggregate();
     void canceled();
     void context();
     void conversion();
+    void superseded();
     void timeout();
     void undefined();
 
@@ -42,6 +44,11 @@ void verify()
 
 } // anonymous namespace
 
+void tst_exceptions::aggregate()
+{
+    verify<QtPromise::QPromiseAggregateException>();
+}
+
 void tst_exceptions::canceled()
 {
     verify<QtPromise::QPromiseCanceledException>();
@@ -57,6 +64,11 @@ void tst_exceptions::conversion()
     verify<QtPromise::QPromiseConversionException>();
 }
 
+void tst_exceptions::superseded()
+{
+    verify<QtPromise::QPromiseSupersededException>();
+}
+
 void tst_exceptions::timeout()
 {
     verify<QtPromise::QPromiseTimeoutException>();
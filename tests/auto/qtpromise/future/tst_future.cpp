@@ -29,6 +29,9 @@ private Q_SLOTS:
     void fail_void();
     void finally();
     void finallyRejected();
+    void manyFutures();
+    void convertedTwice();
+    void nestedFutures();
 
 }; // class tst_future
 
@@ -364,3 +367,71 @@ void tst_future::finallyRejected()
     QCOMPARE(output.isRejected(), true);
     QCOMPARE(error, QString{"foo"});
 }
+
+void tst_future::manyFutures()
+{
+    QVector<QtPromise::QPromise<int>> promises;
+
+    for (int i = 0; i < 1000; ++i) {
+        promises << QtPromise::resolve(QtConcurrent::run([=]() {
+            return i;
+        }));
+    }
+
+    QVector<int> values;
+    QtPromise::all(promises)
+        .then([&](const QVector<int>& res) {
+            values = res;
+        })
+        .wait();
+
+    QCOMPARE(values.size(), 1000);
+    for (int i = 0; i < values.size(); ++i) {
+        QCOMPARE(values[i], i);
+    }
+}
+
+void tst_future::convertedTwice()
+{
+    QFutureInterface<int> iface;
+    iface.reportStarted();
+
+    // Each conversion observes the future, none replaces the other.
+    auto p0 = QtPromise::resolve(iface.future());
+    auto p1 = QtPromise::resolve(iface.future());
+
+    iface.reportResult(42);
+    iface.reportFinished();
+
+    QtPromise::all(QVector<QtPromise::QPromise<int>>{p0, p1}).wait();
+
+    QCOMPARE(p0.isFulfilled(), true);
+    QCOMPARE(p1.isFulfilled(), true);
+}
+
+void tst_future::nestedFutures()
+{
+    int value = -1;
+
+    // A future converted while settling the promise of another future.
+    auto p = QtPromise::resolve(QtConcurrent::run([]() {
+                 return 20;
+             }))
+                 .then([](int res) {
+                     return QtConcurrent::run([=]() {
+                         return res + 1;
+                     });
+                 })
+                 .then([](int res) {
+                     return QtConcurrent::run([=]() {
+                         return res * 2;
+                     });
+                 });
+
+    p.then([&](int res) {
+         value = res;
+     }).wait();
+
+    QCOMPARE(p.isFulfilled(), true);
+    QCOMPARE(value, 42);
+}
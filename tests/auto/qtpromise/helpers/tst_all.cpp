@@ -21,6 +21,9 @@ private Q_SLOTS:
     void allPromisesSucceed_void();
     void atLeastOnePromiseReject();
     void atLeastOnePromiseReject_void();
+    void continueOnFailure();
+    void cancelOnFailure();
+    void cancelOnFailure_void();
     void preserveOrder();
     void sequenceTypes();
     void sequenceTypes_void();
@@ -216,3 +219,62 @@ void tst_helpers_all::sequenceTypes_void()
     SequenceTester<std::list<QtPromise::QPromise<void>>>::exec();
     SequenceTester<std::vector<QtPromise::QPromise<void>>>::exec();
 }
+
+void tst_helpers_all::continueOnFailure()
+{
+    QFutureInterface<int> iface;
+    iface.reportStarted();
+
+    auto p0 = QtPromise::resolve(iface.future());
+    auto p1 = QtPromise::QPromise<int>::reject(QString{"foo"});
+
+    auto p = QtPromise::all(QVector<QtPromise::QPromise<int>>{p0, p1});
+
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+    QCOMPARE(iface.isCanceled(), false);
+
+    iface.reportResult(42);
+    iface.reportFinished();
+
+    QCOMPARE(waitForValue(p0, -1), 42);
+}
+
+void tst_helpers_all::cancelOnFailure()
+{
+    QFutureInterface<int> iface;
+    iface.reportStarted();
+
+    auto p0 = QtPromise::resolve(iface.future());
+    auto p1 = QtPromise::QPromise<int>::reject(QString{"foo"});
+
+    auto p = QtPromise::all(QVector<QtPromise::QPromise<int>>{p0, p1},
+                            QtPromise::FailurePolicy::Cancel);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<QVector<int>>>::value));
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+    QCOMPARE(iface.isCanceled(), true);
+
+    iface.reportFinished();
+
+    QCOMPARE(waitForRejected<QtPromise::QPromiseCanceledException>(p0), true);
+}
+
+void tst_helpers_all::cancelOnFailure_void()
+{
+    QFutureInterface<void> iface;
+    iface.reportStarted();
+
+    auto p0 = QtPromise::resolve(iface.future());
+    auto p1 = QtPromise::QPromise<void>::reject(QString{"foo"});
+
+    auto p = QtPromise::all(QVector<QtPromise::QPromise<void>>{p0, p1},
+                            QtPromise::FailurePolicy::Cancel);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<void>>::value));
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+    QCOMPARE(iface.isCanceled(), true);
+
+    iface.reportFinished();
+
+    QCOMPARE(waitForRejected<QtPromise::QPromiseCanceledException>(p0), true);
+}
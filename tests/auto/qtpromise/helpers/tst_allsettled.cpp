@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+class tst_helpers_allsettled : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void emptySequence();
+    void emptySequence_void();
+    void allFulfilled();
+    void allFulfilled_void();
+    void someRejected();
+    void someRejected_void();
+    void sequenceTypes();
+    void outcome();
+    void nonDefaultConstructible();
+};
+
+QTEST_MAIN(tst_helpers_allsettled)
+#include "tst_allsettled.moc"
+
+namespace {
+
+struct Value
+{
+    explicit Value(int v) : value{v} { }
+    int value;
+};
+
+QString errorOf(const std::exception_ptr& error)
+{
+    try {
+        std::rethrow_exception(error);
+    } catch (const QString& e) {
+        return e;
+    } catch (...) {
+        return {};
+    }
+}
+
+} // anonymous namespace
+
+void tst_helpers_allsettled::emptySequence()
+{
+    auto p = QtPromise::allSettled(QVector<QtPromise::QPromise<int>>{});
+
+    Q_STATIC_ASSERT(
+        (std::is_same<decltype(p),
+                      QtPromise::QPromise<QVector<QtPromise::QPromiseOutcome<int>>>>::value));
+    QCOMPARE(p.isFulfilled(), true);
+    QCOMPARE(waitForValue(p, QVector<QtPromise::QPromiseOutcome<int>>{}).size(), 0);
+}
+
+void tst_helpers_allsettled::emptySequence_void()
+{
+    auto p = QtPromise::allSettled(QVector<QtPromise::QPromise<void>>{});
+
+    Q_STATIC_ASSERT(
+        (std::is_same<decltype(p),
+                      QtPromise::QPromise<QVector<QtPromise::QPromiseOutcome<void>>>>::value));
+    QCOMPARE(p.isFulfilled(), true);
+    QCOMPARE(waitForValue(p, QVector<QtPromise::QPromiseOutcome<void>>{}).size(), 0);
+}
+
+void tst_helpers_allsettled::allFulfilled()
+{
+    auto p0 = QtPromise::resolve(42).delay(100);
+    auto p1 = QtPromise::resolve(43);
+
+    auto p = QtPromise::allSettled(QVector<QtPromise::QPromise<int>>{p0, p1});
+    auto outcomes = waitForValue(p, QVector<QtPromise::QPromiseOutcome<int>>{});
+
+    QCOMPARE(outcomes.size(), 2);
+    QCOMPARE(outcomes[0].isFulfilled(), true);
+    QCOMPARE(outcomes[0].isRejected(), false);
+    QCOMPARE(outcomes[0].value(), 42);
+    QCOMPARE(outcomes[1].isFulfilled(), true);
+    QCOMPARE(outcomes[1].value(), 43);
+}
+
+void tst_helpers_allsettled::allFulfilled_void()
+{
+    auto p0 = QtPromise::resolve().delay(100);
+    auto p1 = QtPromise::resolve();
+
+    auto p = QtPromise::allSettled(QVector<QtPromise::QPromise<void>>{p0, p1});
+    auto outcomes = waitForValue(p, QVector<QtPromise::QPromiseOutcome<void>>{});
+
+    QCOMPARE(outcomes.size(), 2);
+    QCOMPARE(outcomes[0].isFulfilled(), true);
+    QCOMPARE(outcomes[1].isFulfilled(), true);
+    QCOMPARE(outcomes[1].isRejected(), false);
+}
+
+void tst_helpers_allsettled::someRejected()
+{
+    auto p0 = QtPromise::resolve(42).delay(100);
+    auto p1 = QtPromise::QPromise<int>::reject(QString{"foo"});
+    auto p2 = rejectLater<int>(50, "bar");
+
+    auto p = QtPromise::allSettled(QVector<QtPromise::QPromise<int>>{p0, p1, p2});
+    auto outcomes = waitForValue(p, QVector<QtPromise::QPromiseOutcome<int>>{});
+
+    QCOMPARE(p.isFulfilled(), true);
+    QCOMPARE(outcomes.size(), 3);
+    QCOMPARE(outcomes[0].value(), 42);
+    QCOMPARE(outcomes[1].isFulfilled(), false);
+    QCOMPARE(outcomes[1].isRejected(), true);
+    QCOMPARE(errorOf(outcomes[1].error()), QString{"foo"});
+    QCOMPARE(outcomes[2].isRejected(), true);
+    QCOMPARE(errorOf(outcomes[2].error()), QString{"bar"});
+}
+
+void tst_helpers_allsettled::someRejected_void()
+{
+    auto p0 = rejectLater<void>(100, "foo");
+    auto p1 = QtPromise::resolve().delay(50);
+
+    auto p = QtPromise::allSettled(QVector<QtPromise::QPromise<void>>{p0, p1});
+    auto outcomes = waitForValue(p, QVector<QtPromise::QPromiseOutcome<void>>{});
+
+    QCOMPARE(p.isFulfilled(), true);
+    QCOMPARE(outcomes.size(), 2);
+    QCOMPARE(outcomes[0].isRejected(), true);
+    QCOMPARE(errorOf(outcomes[0].error()), QString{"foo"});
+    QCOMPARE(outcomes[1].isFulfilled(), true);
+}
+
+void tst_helpers_allsettled::sequenceTypes()
+{
+    auto p0 = QtPromise::resolve(42);
+    auto p1 = QtPromise::QPromise<int>::reject(QString{"foo"});
+
+    auto p = QtPromise::allSettled(QList<QtPromise::QPromise<int>>{p0, p1});
+    auto outcomes = waitForValue(p, QVector<QtPromise::QPromiseOutcome<int>>{});
+    QCOMPARE(outcomes[0].isFulfilled(), true);
+    QCOMPARE(outcomes[1].isRejected(), true);
+
+    p = QtPromise::allSettled(std::list<QtPromise::QPromise<int>>{p1, p0});
+    outcomes = waitForValue(p, QVector<QtPromise::QPromiseOutcome<int>>{});
+    QCOMPARE(outcomes[0].isRejected(), true);
+    QCOMPARE(outcomes[1].isFulfilled(), true);
+
+    p = QtPromise::allSettled(std::vector<QtPromise::QPromise<int>>{p0, p0});
+    outcomes = waitForValue(p, QVector<QtPromise::QPromiseOutcome<int>>{});
+    QCOMPARE(outcomes[0].value(), 42);
+    QCOMPARE(outcomes[1].value(), 42);
+}
+
+void tst_helpers_allsettled::outcome()
+{
+    using Outcome = QtPromise::QPromiseOutcome<std::exception_ptr>;
+
+    // Values and errors are never implicitly converted to an outcome.
+    Q_STATIC_ASSERT((!std::is_convertible<int, QtPromise::QPromiseOutcome<int>>::value));
+    Q_STATIC_ASSERT((!std::is_convertible<std::exception_ptr, Outcome>::value));
+
+    auto error = std::make_exception_ptr(QString{"foo"});
+
+    auto fulfilled = Outcome::fulfilled(error);
+    QCOMPARE(fulfilled.isFulfilled(), true);
+    QCOMPARE(fulfilled.isRejected(), false);
+    QCOMPARE(errorOf(fulfilled.value()), QString{"foo"});
+
+    auto rejected = Outcome::rejected(error);
+    QCOMPARE(rejected.isFulfilled(), false);
+    QCOMPARE(rejected.isRejected(), true);
+    QCOMPARE(errorOf(rejected.error()), QString{"foo"});
+
+    Outcome pending;
+    QCOMPARE(pending.isFulfilled(), false);
+    QCOMPARE(pending.isRejected(), false);
+}
+
+void tst_helpers_allsettled::nonDefaultConstructible()
+{
+    auto p0 = QtPromise::resolve(Value{42});
+    auto p1 = QtPromise::QPromise<Value>::reject(QString{"foo"});
+
+    auto p = QtPromise::allSettled(QVector<QtPromise::QPromise<Value>>{p0, p1});
+    auto outcomes = waitForValue(p, QVector<QtPromise::QPromiseOutcome<Value>>{});
+
+    QCOMPARE(outcomes.size(), 2);
+    QCOMPARE(outcomes[0].isFulfilled(), true);
+    QCOMPARE(outcomes[0].value().value, 42);
+    QCOMPARE(outcomes[1].isRejected(), true);
+    QCOMPARE(errorOf(outcomes[1].error()), QString{"foo"});
+}
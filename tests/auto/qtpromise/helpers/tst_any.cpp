@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+class tst_helpers_any : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void emptySequence();
+    void emptySequence_void();
+    void firstFulfilled();
+    void firstFulfilled_void();
+    void allRejected();
+    void allRejected_void();
+    void cancelLosers();
+};
+
+QTEST_MAIN(tst_helpers_any)
+#include "tst_any.moc"
+
+namespace {
+
+QStringList errorsOf(const QtPromise::QPromiseAggregateException& aggregate)
+{
+    QStringList errors;
+    for (const auto& error : aggregate.errors()) {
+        try {
+            std::rethrow_exception(error);
+        } catch (const QString& e) {
+            errors << e;
+        } catch (...) {
+            errors << QString{};
+        }
+    }
+    return errors;
+}
+
+} // anonymous namespace
+
+void tst_helpers_any::emptySequence()
+{
+    auto p = QtPromise::any(QVector<QtPromise::QPromise<int>>{});
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<int>>::value));
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(waitForRejected<QtPromise::QPromiseAggregateException>(p), true);
+}
+
+void tst_helpers_any::emptySequence_void()
+{
+    auto p = QtPromise::any(QVector<QtPromise::QPromise<void>>{});
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<void>>::value));
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(waitForRejected<QtPromise::QPromiseAggregateException>(p), true);
+}
+
+void tst_helpers_any::firstFulfilled()
+{
+    auto p0 = rejectLater<int>(50, "foo");
+    auto p1 = QtPromise::resolve(42).delay(500);
+    auto p2 = QtPromise::resolve(43).delay(200);
+
+    auto p = QtPromise::any(QVector<QtPromise::QPromise<int>>{p0, p1, p2});
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<int>>::value));
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForValue(p, -1), 43);
+    QCOMPARE(p0.isRejected(), true);
+    QCOMPARE(p1.isPending(), true);
+}
+
+void tst_helpers_any::firstFulfilled_void()
+{
+    auto p0 = rejectLater<void>(50, "foo");
+    auto p1 = QtPromise::resolve().delay(200);
+
+    auto p = QtPromise::any(QVector<QtPromise::QPromise<void>>{p0, p1});
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<void>>::value));
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+    QCOMPARE(p0.isRejected(), true);
+}
+
+void tst_helpers_any::allRejected()
+{
+    auto p0 = rejectLater<int>(200, "foo");
+    auto p1 = rejectLater<int>(50, "bar");
+    auto p2 = QtPromise::QPromise<int>::reject(QString{"baz"});
+
+    auto p = QtPromise::any(QVector<QtPromise::QPromise<int>>{p0, p1, p2});
+    auto e = waitForError(p, QtPromise::QPromiseAggregateException{});
+
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(errorsOf(e), (QStringList{"foo", "bar", "baz"}));
+}
+
+void tst_helpers_any::allRejected_void()
+{
+    auto p0 = rejectLater<void>(200, "foo");
+    auto p1 = QtPromise::QPromise<void>::reject(QString{"bar"});
+
+    auto p = QtPromise::any(QVector<QtPromise::QPromise<void>>{p0, p1});
+    auto e = waitForError(p, QtPromise::QPromiseAggregateException{});
+
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(errorsOf(e), (QStringList{"foo", "bar"}));
+}
+
+void tst_helpers_any::cancelLosers()
+{
+    QFutureInterface<int> iface;
+    iface.reportStarted();
+
+    auto p0 = QtPromise::resolve(iface.future());
+    auto p1 = QtPromise::resolve(42).delay(100);
+
+    auto p = QtPromise::any(QVector<QtPromise::QPromise<int>>{p0, p1});
+
+    QCOMPARE(waitForValue(p, -1), 42);
+    QCOMPARE(iface.isCanceled(), true);
+
+    iface.reportFinished();
+
+    QCOMPARE(waitForRejected<QtPromise::QPromiseCanceledException>(p0), true);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+class tst_helpers_ascompleted : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void emptySequence();
+    void completionOrder();
+    void completionOrder_void();
+    void functorThrows();
+    void functorThrows_void();
+};
+
+QTEST_MAIN(tst_helpers_ascompleted)
+#include "tst_ascompleted.moc"
+
+void tst_helpers_ascompleted::emptySequence()
+{
+    int calls = 0;
+    auto p = QtPromise::asCompleted(QVector<QtPromise::QPromise<int>>{},
+                                    [&](const QtPromise::QPromiseOutcome<int>&, int) {
+                                        ++calls;
+                                    });
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<void>>::value));
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+    QCOMPARE(calls, 0);
+}
+
+void tst_helpers_ascompleted::completionOrder()
+{
+    auto p0 = QtPromise::resolve(42).delay(200);
+    auto p1 = rejectLater<int>(100, "foo");
+    auto p2 = QtPromise::resolve(43).delay(50);
+
+    QVector<int> indices;
+    QVector<int> values;
+    auto p = QtPromise::asCompleted(QVector<QtPromise::QPromise<int>>{p0, p1, p2},
+                                    [&](const QtPromise::QPromiseOutcome<int>& outcome, int index) {
+                                        indices << index;
+                                        values << (outcome.isFulfilled() ? outcome.value() : -1);
+                                    });
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<void>>::value));
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+    QCOMPARE(indices, (QVector<int>{2, 1, 0}));
+    QCOMPARE(values, (QVector<int>{43, -1, 42}));
+}
+
+void tst_helpers_ascompleted::completionOrder_void()
+{
+    auto p0 = QtPromise::resolve().delay(200);
+    auto p1 = rejectLater<void>(100, "foo");
+    auto p2 = QtPromise::resolve().delay(50);
+
+    QVector<int> indices;
+    QVector<bool> fulfilled;
+    auto p = QtPromise::asCompleted(
+        QVector<QtPromise::QPromise<void>>{p0, p1, p2},
+        [&](const QtPromise::QPromiseOutcome<void>& outcome, int index) {
+            indices << index;
+            fulfilled << outcome.isFulfilled();
+        });
+
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+    QCOMPARE(indices, (QVector<int>{2, 1, 0}));
+    QCOMPARE(fulfilled, (QVector<bool>{true, false, true}));
+}
+
+void tst_helpers_ascompleted::functorThrows()
+{
+    auto p0 = QtPromise::resolve(42).delay(200);
+    auto p1 = QtPromise::resolve(43).delay(50);
+
+    QVector<int> indices;
+    auto p = QtPromise::asCompleted(QVector<QtPromise::QPromise<int>>{p0, p1},
+                                    [&](const QtPromise::QPromiseOutcome<int>&, int index) {
+                                        indices << index;
+                                        throw QString{"foo"};
+                                    });
+
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+    QCOMPARE(indices, QVector<int>{1});
+    QCOMPARE(waitForValue(p0, -1), 42);
+    QCOMPARE(indices, QVector<int>{1});
+}
+
+void tst_helpers_ascompleted::functorThrows_void()
+{
+    auto p0 = QtPromise::resolve().delay(50);
+
+    auto p = QtPromise::asCompleted(QVector<QtPromise::QPromise<void>>{p0},
+                                    [&](const QtPromise::QPromiseOutcome<void>&, int) {
+                                        throw QString{"foo"};
+                                    });
+
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+}
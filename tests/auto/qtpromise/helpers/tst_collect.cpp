@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtConcurrent>
+#include <QtPromise>
+#include <QtTest>
+
+class tst_helpers_collect : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void results();
+    void singleResult();
+    void empty();
+    void rejected();
+};
+
+QTEST_MAIN(tst_helpers_collect)
+#include "tst_collect.moc"
+
+void tst_helpers_collect::results()
+{
+    QFutureInterface<QString> source;
+
+    source.reportStarted();
+
+    auto p = QtPromise::collect(source.future());
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<QVector<QString>>>::value));
+
+    source.reportResult(QString{"foo"});
+    QCoreApplication::processEvents();
+    source.reportResult(QString{"bar"});
+    source.reportResult(QString{"baz"});
+    source.reportFinished();
+
+    QCOMPARE(waitForValue(p, QVector<QString>{}), (QVector<QString>{"foo", "bar", "baz"}));
+}
+
+void tst_helpers_collect::singleResult()
+{
+    auto p = QtPromise::collect(QtConcurrent::run([]() {
+        return 42;
+    }));
+
+    QCOMPARE(waitForValue(p, QVector<int>{}), QVector<int>{42});
+}
+
+void tst_helpers_collect::empty()
+{
+    QFutureInterface<int> source;
+
+    source.reportStarted();
+    source.reportFinished();
+
+    auto p = QtPromise::collect(source.future());
+
+    QCOMPARE(waitForValue(p, QVector<int>{-1}), QVector<int>{});
+}
+
+void tst_helpers_collect::rejected()
+{
+    auto p = QtPromise::collect(QtConcurrent::run([]() -> int {
+        throw QtPromise::QPromiseTimeoutException{};
+    }));
+
+    QCOMPARE(waitForRejected<QtPromise::QPromiseTimeoutException>(p), true);
+}
@@ -20,11 +20,13 @@ private Q_SLOTS:
     void resolveOneSenderNoArg();
     void resolveOneSenderOneArg();
     void resolveOneSenderManyArgs();
+    void resolveOneSenderPrivateSignal();
 
     // connect(QObject* sender, Signal resolver, Signal rejecter)
     void rejectOneSenderNoArg();
     void rejectOneSenderOneArg();
     void rejectOneSenderManyArgs();
+    void rejectOneSenderPrivateSignal();
     void rejectOneSenderDestroyed();
 
     // connect(QObject* s0, Signal resolver, QObject* s1, Signal rejecter)
@@ -75,10 +77,35 @@ void tst_helpers_connect::resolveOneSenderManyArgs()
     });
 
     auto p = QtPromise::connect(&sender, &Object::twoArgsSignal);
-    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<int>>::value));
+    Q_STATIC_ASSERT(
+        (std::is_same<decltype(p), QtPromise::QPromise<std::tuple<int, QString>>>::value));
     QCOMPARE(sender.hasConnections(), true);
     QCOMPARE(p.isPending(), true);
-    QCOMPARE(waitForValue(p, -1), 42);
+    QCOMPARE(waitForValue(p, std::make_tuple(-1, QString{})), std::make_tuple(42, QString{"foo"}));
+    QCOMPARE(sender.hasConnections(), false);
+}
+
+void tst_helpers_connect::resolveOneSenderPrivateSignal()
+{
+    Object sender;
+    QtPromisePrivate::qtpromise_defer([&]() {
+        sender.emitPrivateNoArgSignal();
+        sender.emitPrivateOneArgSignal("foo");
+        sender.emitPrivateTwoArgsSignal(42, "bar");
+    });
+
+    // The trailing QPrivateSignal argument is ignored.
+    auto p0 = QtPromise::connect(&sender, &Object::privateNoArgSignal);
+    auto p1 = QtPromise::connect(&sender, &Object::privateOneArgSignal);
+    auto p2 = QtPromise::connect(&sender, &Object::privateTwoArgsSignal);
+    Q_STATIC_ASSERT((std::is_same<decltype(p0), QtPromise::QPromise<void>>::value));
+    Q_STATIC_ASSERT((std::is_same<decltype(p1), QtPromise::QPromise<QString>>::value));
+    Q_STATIC_ASSERT(
+        (std::is_same<decltype(p2), QtPromise::QPromise<std::tuple<int, QString>>>::value));
+
+    QCOMPARE(waitForValue(p0, -1, 42), 42);
+    QCOMPARE(waitForValue(p1, QString{}), QString{"foo"});
+    QCOMPARE(waitForValue(p2, std::make_tuple(-1, QString{})), std::make_tuple(42, QString{"bar"}));
     QCOMPARE(sender.hasConnections(), false);
 }
 
@@ -127,6 +154,19 @@ void tst_helpers_connect::rejectOneSenderManyArgs()
     QCOMPARE(sender.hasConnections(), false);
 }
 
+void tst_helpers_connect::rejectOneSenderPrivateSignal()
+{
+    Object sender;
+    QtPromisePrivate::qtpromise_defer([&]() {
+        sender.emitPrivateNoArgSignal();
+    });
+
+    auto p = QtPromise::connect(&sender, &Object::oneArgSignal, &Object::privateNoArgSignal);
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<QString>>::value));
+    QCOMPARE(waitForRejected<QtPromise::QPromiseUndefinedException>(p), true);
+    QCOMPARE(sender.hasConnections(), false);
+}
+
 void tst_helpers_connect::rejectOneSenderDestroyed()
 {
     auto sender = new Object{};
@@ -135,7 +175,8 @@ void tst_helpers_connect::rejectOneSenderDestroyed()
     });
 
     auto p = QtPromise::connect(sender, &Object::twoArgsSignal);
-    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<int>>::value));
+    Q_STATIC_ASSERT(
+        (std::is_same<decltype(p), QtPromise::QPromise<std::tuple<int, QString>>>::value));
     QCOMPARE(p.isPending(), true);
     QCOMPARE(waitForRejected<QtPromise::QPromiseContextException>(p), true);
 }
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace QtPromise;
+
+class tst_helpers_debounce : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void coalesced();
+    void coalesced_void();
+    void latestArguments();
+    void separateWindows();
+    void functorThrows();
+    void functorReturnsPromise();
+    void destroyed();
+    void destroyedFromOtherThread();
+};
+
+QTEST_MAIN(tst_helpers_debounce)
+#include "tst_debounce.moc"
+
+void tst_helpers_debounce::coalesced()
+{
+    int calls = 0;
+    auto fn = QtPromise::debounce(
+        [&]() {
+            return ++calls;
+        },
+        50);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(fn), std::function<QPromise<int>()>>::value));
+
+    auto p0 = fn();
+    auto p1 = fn();
+    auto p2 = fn();
+
+    QCOMPARE(calls, 0);
+    QCOMPARE(p0.isPending(), true);
+    QCOMPARE(waitForValue(p0, -1), 1);
+    QCOMPARE(waitForValue(p1, -1), 1);
+    QCOMPARE(waitForValue(p2, -1), 1);
+    QCOMPARE(calls, 1);
+}
+
+void tst_helpers_debounce::coalesced_void()
+{
+    int calls = 0;
+    auto fn = QtPromise::debounce(
+        [&]() {
+            ++calls;
+        },
+        std::chrono::milliseconds{50});
+
+    Q_STATIC_ASSERT((std::is_same<decltype(fn), std::function<QPromise<void>()>>::value));
+
+    auto p0 = fn();
+    auto p1 = fn();
+
+    QCOMPARE(waitForValue(p0, -1, 42), 42);
+    QCOMPARE(waitForValue(p1, -1, 42), 42);
+    QCOMPARE(calls, 1);
+}
+
+void tst_helpers_debounce::latestArguments()
+{
+    QStringList queries;
+    auto fn = QtPromise::debounce(
+        [&](const QString& query) {
+            queries << query;
+            return static_cast<int>(query.size());
+        },
+        50);
+
+    Q_STATIC_ASSERT(
+        (std::is_same<decltype(fn), std::function<QPromise<int>(const QString&)>>::value));
+
+    auto p0 = fn("f");
+    auto p1 = fn("fo");
+    auto p2 = fn("foo");
+
+    QCOMPARE(waitForValue(p0, -1), 3);
+    QCOMPARE(waitForValue(p1, -1), 3);
+    QCOMPARE(waitForValue(p2, -1), 3);
+    QCOMPARE(queries, QStringList{"foo"});
+}
+
+void tst_helpers_debounce::separateWindows()
+{
+    int calls = 0;
+    auto fn = QtPromise::debounce(
+        [&]() {
+            return ++calls;
+        },
+        100);
+
+    // Each call restarts the window.
+    QElapsedTimer timer;
+    timer.start();
+
+    auto p0 = fn();
+    for (int i = 0; i < 4; ++i) {
+        QTest::qWait(25);
+        fn();
+    }
+
+    QCOMPARE(p0.isPending(), true);
+    QCOMPARE(waitForValue(p0, -1), 1);
+    QVERIFY(timer.elapsed() >= 190);
+
+    QCOMPARE(waitForValue(fn(), -1), 2);
+    QCOMPARE(calls, 2);
+}
+
+void tst_helpers_debounce::functorThrows()
+{
+    auto fn = QtPromise::debounce(
+        [&]() -> int {
+            throw QString{"foo"};
+        },
+        10);
+
+    auto p0 = fn();
+    auto p1 = fn();
+
+    QCOMPARE(waitForError(p0, QString{}), QString{"foo"});
+    QCOMPARE(waitForError(p1, QString{}), QString{"foo"});
+}
+
+void tst_helpers_debounce::functorReturnsPromise()
+{
+    int calls = 0;
+    auto fn = QtPromise::debounce(
+        [&](int value) {
+            ++calls;
+            return QtPromise::resolve(value).delay(50);
+        },
+        10);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(fn), std::function<QPromise<int>(int)>>::value));
+
+    auto p0 = fn(42);
+    auto p1 = fn(43);
+
+    QCOMPARE(waitForValue(p0, -1), 43);
+    QCOMPARE(waitForValue(p1, -1), 43);
+    QCOMPARE(calls, 1);
+}
+
+void tst_helpers_debounce::destroyed()
+{
+    int calls = 0;
+    auto p = [&]() {
+        auto fn = QtPromise::debounce(
+            [&]() {
+                return ++calls;
+            },
+            10);
+
+        return fn();
+    }();
+
+    // Pending calls are canceled when the last copy of the wrapper is deleted.
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p), true);
+    QCOMPARE(calls, 0);
+}
+
+void tst_helpers_debounce::destroyedFromOtherThread()
+{
+    int calls = 0;
+    auto fn = [&]() {
+        return QtPromise::debounce(
+            [&]() {
+                return ++calls;
+            },
+            10);
+    };
+
+    auto holder = std::make_shared<decltype(fn())>(fn());
+    auto p = (*holder)();
+
+    // The last copy of the wrapper is released from another thread than the timer one.
+    std::thread{[&]() {
+        holder.reset();
+    }}.join();
+
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p), true);
+    QTest::qWait(50);
+    QCOMPARE(calls, 0);
+}
@@ -20,6 +20,7 @@ private Q_SLOTS:
     void ignoreResult();
     void delayedFulfilled();
     void delayedRejected();
+    void cancelOnFailure();
     void functorThrows();
     void functorArguments();
     void sequenceTypes();
@@ -152,3 +153,23 @@ void tst_helpers_each::sequenceTypes()
     SequenceTester<std::list<int>>::exec();
     SequenceTester<std::vector<int>>::exec();
 }
+
+void tst_helpers_each::cancelOnFailure()
+{
+    QFutureInterface<int> iface;
+    iface.reportStarted();
+
+    auto p = QtPromise::each(
+        QVector<int>{42, 43, 44},
+        [&](int v, ...) {
+            return v == 42 ? QtPromise::resolve(iface.future())
+                           : QtPromise::QPromise<int>::reject(QString{"foo"});
+        },
+        QtPromise::FailurePolicy::Cancel);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<QVector<int>>>::value));
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+    QCOMPARE(iface.isCanceled(), true);
+
+    iface.reportFinished();
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtConcurrent>
+#include <QtPromise>
+#include <QtTest>
+
+class tst_helpers_eachresult : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void incremental();
+    void finished();
+    void empty();
+    void functorThrows();
+    void futureThrows();
+    void canceled();
+};
+
+QTEST_MAIN(tst_helpers_eachresult)
+#include "tst_eachresult.moc"
+
+void tst_helpers_eachresult::incremental()
+{
+    QFutureInterface<int> source;
+    QVector<int> values;
+    QVector<int> indices;
+
+    source.reportStarted();
+
+    auto p = QtPromise::eachResult(source.future(), [&](int value, int index) {
+        values << value;
+        indices << index;
+    });
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<void>>::value));
+
+    source.reportResult(42);
+    source.reportResult(43);
+    QCoreApplication::processEvents();
+
+    // Results are delivered while the future is still running.
+    QCOMPARE(values, (QVector<int>{42, 43}));
+    QCOMPARE(p.isPending(), true);
+
+    source.reportResult(44);
+    source.reportFinished();
+
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+    QCOMPARE(values, (QVector<int>{42, 43, 44}));
+    QCOMPARE(indices, (QVector<int>{0, 1, 2}));
+}
+
+void tst_helpers_eachresult::finished()
+{
+    QFutureInterface<int> source;
+    QVector<int> values;
+
+    source.reportStarted();
+    source.reportResult(42);
+    source.reportResult(43);
+    source.reportFinished();
+
+    auto p = QtPromise::eachResult(source.future(), [&](int value, int) {
+        values << value;
+    });
+
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+    QCOMPARE(values, (QVector<int>{42, 43}));
+}
+
+void tst_helpers_eachresult::empty()
+{
+    QFutureInterface<int> source;
+    int calls = 0;
+
+    source.reportStarted();
+    source.reportFinished();
+
+    auto p = QtPromise::eachResult(source.future(), [&](int, int) {
+        ++calls;
+    });
+
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+    QCOMPARE(calls, 0);
+}
+
+void tst_helpers_eachresult::functorThrows()
+{
+    QFutureInterface<int> source;
+    QVector<int> values;
+
+    source.reportStarted();
+
+    auto p = QtPromise::eachResult(source.future(), [&](int value, int) {
+        if (value == 43) {
+            throw QString{"foo"};
+        }
+        values << value;
+    });
+
+    source.reportResult(42);
+    source.reportResult(43);
+    source.reportResult(44);
+
+    // The remaining work is canceled and the remaining results ignored.
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+    QCOMPARE(values, QVector<int>{42});
+    QCOMPARE(source.isCanceled(), true);
+
+    source.reportFinished();
+}
+
+void tst_helpers_eachresult::futureThrows()
+{
+    QVector<int> values;
+
+    auto p = QtPromise::eachResult(QtConcurrent::run([]() -> int {
+                                       throw QtPromise::QPromiseTimeoutException{};
+                                   }),
+                                   [&](int value, int) {
+                                       values << value;
+                                   });
+
+    QCOMPARE(waitForRejected<QtPromise::QPromiseTimeoutException>(p), true);
+    QCOMPARE(values.isEmpty(), true);
+}
+
+void tst_helpers_eachresult::canceled()
+{
+    QFutureInterface<int> source;
+
+    source.reportStarted();
+
+    auto p = QtPromise::eachResult(source.future(), [&](int, int) {});
+
+    source.cancel();
+    source.reportFinished();
+
+    QCOMPARE(waitForRejected<QtPromise::QPromiseCanceledException>(p), true);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+#include <chrono>
+
+class tst_helpers_every : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void ticks();
+    void driftCompensation();
+    void missedTicks();
+    void stop();
+    void destroyed();
+    void stdChrono();
+};
+
+QTEST_MAIN(tst_helpers_every)
+#include "tst_every.moc"
+
+void tst_helpers_every::ticks()
+{
+    auto ticker = QtPromise::every(50);
+
+    QCOMPARE(ticker.interval(), 50);
+    QCOMPARE(ticker.isActive(), true);
+
+    auto p = ticker.next();
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<int>>::value));
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForValue(p, -1), 1);
+    QCOMPARE(waitForValue(ticker.next(), -1), 1);
+}
+
+void tst_helpers_every::driftCompensation()
+{
+    QElapsedTimer timer;
+    int ticks = 0;
+
+    timer.start();
+
+    auto ticker = QtPromise::every(50);
+    while (ticks < 10) {
+        ticks += waitForValue(ticker.next(), -1);
+
+        // Simulate some work between two ticks, which must not delay the next one.
+        QThread::msleep(10);
+    }
+
+    QCOMPARE(ticks, 10);
+    QVERIFY(timer.elapsed() >= 500);
+    QVERIFY(timer.elapsed() < 600);
+}
+
+void tst_helpers_every::missedTicks()
+{
+    auto ticker = QtPromise::every(20);
+
+    // Block the event loop for more than 5 intervals: missed ticks are coalesced.
+    QThread::msleep(110);
+
+    QVERIFY(waitForValue(ticker.next(), -1) >= 5);
+    QCOMPARE(waitForValue(ticker.next(), -1), 1);
+}
+
+void tst_helpers_every::stop()
+{
+    auto ticker = QtPromise::every(50);
+    auto p = ticker.next();
+
+    ticker.stop();
+
+    QCOMPARE(ticker.isActive(), false);
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(waitForRejected<QtPromise::QPromiseCanceledException>(p), true);
+    QCOMPARE(waitForRejected<QtPromise::QPromiseCanceledException>(ticker.next()), true);
+}
+
+void tst_helpers_every::destroyed()
+{
+    auto p = QtPromise::resolve(-1);
+
+    {
+        auto ticker = QtPromise::every(50);
+        p = ticker.next();
+        QCOMPARE(p.isPending(), true);
+    }
+
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(waitForRejected<QtPromise::QPromiseCanceledException>(p), true);
+}
+
+void tst_helpers_every::stdChrono()
+{
+    auto ticker = QtPromise::every(std::chrono::milliseconds{50});
+
+    QCOMPARE(ticker.interval(), 50);
+    QCOMPARE(waitForValue(ticker.next(), -1), 1);
+}
@@ -20,6 +20,7 @@ private Q_SLOTS:
     void filterValues();
     void delayedFulfilled();
     void delayedRejected();
+    void cancelOnFailure();
     void functorThrows();
     void functorArguments();
     void preserveOrder();
@@ -144,3 +145,23 @@ void tst_helpers_filter::sequenceTypes()
     SequenceTester<std::list<int>>::exec();
     SequenceTester<std::vector<int>>::exec();
 }
+
+void tst_helpers_filter::cancelOnFailure()
+{
+    QFutureInterface<bool> iface;
+    iface.reportStarted();
+
+    auto p = QtPromise::filter(
+        QVector<int>{42, 43, 44},
+        [&](int v, ...) {
+            return v == 42 ? QtPromise::resolve(iface.future())
+                           : QtPromise::QPromise<bool>::reject(QString{"foo"});
+        },
+        QtPromise::FailurePolicy::Cancel);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<QVector<int>>>::value));
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+    QCOMPARE(iface.isCanceled(), true);
+
+    iface.reportFinished();
+}
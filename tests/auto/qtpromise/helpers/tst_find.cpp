@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+class tst_helpers_find : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void emptySequence();
+    void notFound();
+    void found();
+    void foundIndex();
+    void lazyEvaluation();
+    void boundedConcurrency();
+    void lowestIndexWins();
+    void functorThrows();
+    void functorRejects();
+    void sequenceTypes();
+};
+
+QTEST_MAIN(tst_helpers_find)
+#include "tst_find.moc"
+
+void tst_helpers_find::emptySequence()
+{
+    auto p = QtPromise::find(QVector<int>{}, [](int, int) {
+        return true;
+    });
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<int>>::value));
+    QCOMPARE(waitForValue(p, -1), 0);
+
+    auto i = QtPromise::findIndex(QVector<int>{}, [](int, int) {
+        return true;
+    });
+
+    Q_STATIC_ASSERT((std::is_same<decltype(i), QtPromise::QPromise<int>>::value));
+    QCOMPARE(waitForValue(i, 42), -1);
+}
+
+void tst_helpers_find::notFound()
+{
+    auto p = QtPromise::findIndex(QVector<int>{1, 2, 3}, [](int v, int) {
+        return QtPromise::resolve(v > 3).delay(10);
+    });
+
+    QCOMPARE(waitForValue(p, 42), -1);
+}
+
+void tst_helpers_find::found()
+{
+    auto p = QtPromise::find(QVector<QString>{"foo", "bar", "baz"}, [](const QString& v, int) {
+        return QtPromise::resolve(v.startsWith("b")).delay(10);
+    });
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<QString>>::value));
+    QCOMPARE(waitForValue(p, QString{}), QString{"bar"});
+}
+
+void tst_helpers_find::foundIndex()
+{
+    auto p = QtPromise::findIndex(QVector<int>{1, 2, 3, 4}, [](int v, int) {
+        return v % 2 == 0;
+    });
+
+    QCOMPARE(waitForValue(p, -1), 1);
+}
+
+void tst_helpers_find::lazyEvaluation()
+{
+    // By default, the predicate is evaluated on one value at a time and not called
+    // anymore once a value is found.
+    QVector<int> calls;
+    auto p = QtPromise::findIndex(QVector<int>{1, 2, 3, 4}, [&](int v, int i) {
+        calls << i;
+        return QtPromise::resolve(v == 2).delay(10);
+    });
+
+    QCOMPARE(calls, QVector<int>{0});
+    QCOMPARE(waitForValue(p, -1), 1);
+    QCOMPARE(calls, (QVector<int>{0, 1}));
+}
+
+void tst_helpers_find::boundedConcurrency()
+{
+    int running = 0;
+    int maxRunning = 0;
+    QVector<int> calls;
+    QVector<QtPromise::QPromise<bool>> predicates;
+
+    auto p = QtPromise::findIndex(
+        QVector<int>{1, 2, 3, 4, 5, 6, 7, 8},
+        [&](int v, int i) {
+            calls << i;
+            maxRunning = qMax(maxRunning, ++running);
+            predicates << QtPromise::resolve(v == 5).delay(10).finally([&]() {
+                running--;
+            });
+            return predicates.last();
+        },
+        3);
+
+    QCOMPARE(calls, (QVector<int>{0, 1, 2}));
+    QCOMPARE(waitForValue(p, -1), 4);
+    QCOMPARE(maxRunning, 3);
+    QVERIFY(calls.size() < 8);
+
+    // Wait for the evaluations still running when the value has been found.
+    QtPromise::all(predicates).wait();
+    QCOMPARE(running, 0);
+}
+
+void tst_helpers_find::lowestIndexWins()
+{
+    // The second value is found first but the first value also matches.
+    auto p = QtPromise::findIndex(
+        QVector<int>{100, 10, 1},
+        [](int v, int) {
+            return QtPromise::resolve(v >= 10).delay(v);
+        },
+        3);
+
+    QCOMPARE(waitForValue(p, -1), 0);
+}
+
+void tst_helpers_find::functorThrows()
+{
+    auto p = QtPromise::findIndex(QVector<int>{1, 2, 3}, [](int v, int) {
+        if (v == 2) {
+            throw QString{"foo"};
+        }
+        return false;
+    });
+
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+}
+
+void tst_helpers_find::functorRejects()
+{
+    auto p = QtPromise::find(QVector<int>{1, 2, 3}, [](int v, int) {
+        return QtPromise::QPromise<bool>{[&](const QtPromise::QPromiseResolve<bool>& resolve,
+                                             const QtPromise::QPromiseReject<bool>& reject) {
+            if (v == 2) {
+                reject(QString{"foo"});
+            } else {
+                resolve(false);
+            }
+        }};
+    });
+
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+}
+
+void tst_helpers_find::sequenceTypes()
+{
+    auto fn = [](int v, int) {
+        return QtPromise::resolve(v > 1);
+    };
+
+    QCOMPARE(waitForValue(QtPromise::find(QList<int>{1, 2, 3}, fn), -1), 2);
+    QCOMPARE(waitForValue(QtPromise::find(std::list<int>{1, 2, 3}, fn), -1), 2);
+    QCOMPARE(waitForValue(QtPromise::find(std::vector<int>{1, 2, 3}, fn), -1), 2);
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+#include <chrono>
+
+class tst_helpers_hedge : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void firstAttemptFulfilled();
+    void firstAttemptFulfilled_void();
+    void hedgedAttemptFulfilled();
+    void hedgedAttemptFulfilled_void();
+    void rejectedAttempt();
+    void allAttemptsRejected();
+    void functorThrows();
+    void functorReturnsValue();
+    void maxAttempts();
+    void cancelAttempts();
+    void chronoDelay();
+};
+
+QTEST_MAIN(tst_helpers_hedge)
+#include "tst_hedge.moc"
+
+void tst_helpers_hedge::firstAttemptFulfilled()
+{
+    int calls = 0;
+    auto p = QtPromise::hedge(
+        [&]() {
+            return QtPromise::resolve(++calls).delay(50);
+        },
+        500,
+        3);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<int>>::value));
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(calls, 1);
+    QCOMPARE(waitForValue(p, -1), 1);
+    QCOMPARE(calls, 1);
+}
+
+void tst_helpers_hedge::firstAttemptFulfilled_void()
+{
+    int calls = 0;
+    auto p = QtPromise::hedge(
+        [&]() {
+            ++calls;
+            return QtPromise::resolve().delay(50);
+        },
+        500,
+        3);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<void>>::value));
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+    QCOMPARE(calls, 1);
+}
+
+void tst_helpers_hedge::hedgedAttemptFulfilled()
+{
+    QVector<QtPromise::QPromise<int>> attempts;
+    auto p = QtPromise::hedge(
+        [&]() {
+            // First attempt is slow, the next ones are fast.
+            attempts << QtPromise::resolve(attempts.size()).delay(attempts.isEmpty() ? 1000 : 50);
+            return attempts.last();
+        },
+        100,
+        3);
+
+    QCOMPARE(waitForValue(p, -1), 1);
+    QCOMPARE(attempts.size(), 2);
+    QCOMPARE(attempts[0].isPending(), true);
+}
+
+void tst_helpers_hedge::hedgedAttemptFulfilled_void()
+{
+    int calls = 0;
+    auto p = QtPromise::hedge(
+        [&]() {
+            return QtPromise::resolve().delay(calls++ == 0 ? 1000 : 50);
+        },
+        100,
+        3);
+
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+    QCOMPARE(calls, 2);
+}
+
+void tst_helpers_hedge::rejectedAttempt()
+{
+    // A rejected attempt immediately starts the next one, without waiting for the delay.
+    int calls = 0;
+    auto p = QtPromise::hedge(
+        [&]() {
+            return calls++ == 0 ? rejectLater<int>(10, "foo") : QtPromise::resolve(42);
+        },
+        1000,
+        2);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QCOMPARE(waitForValue(p, -1), 42);
+    QCOMPARE(calls, 2);
+    QVERIFY(timer.elapsed() < 500);
+}
+
+void tst_helpers_hedge::allAttemptsRejected()
+{
+    int calls = 0;
+    auto p = QtPromise::hedge(
+        [&]() {
+            ++calls;
+            return calls == 1 ? rejectLater<int>(200, "foo") : rejectLater<int>(10, "bar");
+        },
+        50,
+        2);
+
+    QCOMPARE(waitForRejected<QtPromise::QPromiseAggregateException>(p), true);
+    QCOMPARE(calls, 2);
+
+    auto e = waitForError(p, QtPromise::QPromiseAggregateException{});
+    QCOMPARE(e.errors().size(), 2);
+}
+
+void tst_helpers_hedge::functorThrows()
+{
+    int calls = 0;
+    auto p = QtPromise::hedge(
+        [&]() {
+            if (calls++ == 0) {
+                throw QString{"foo"};
+            }
+            return QtPromise::resolve(42);
+        },
+        1000,
+        2);
+
+    QCOMPARE(waitForValue(p, -1), 42);
+    QCOMPARE(calls, 2);
+}
+
+void tst_helpers_hedge::functorReturnsValue()
+{
+    auto p = QtPromise::hedge(
+        []() {
+            return 42;
+        },
+        100,
+        2);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<int>>::value));
+    QCOMPARE(waitForValue(p, -1), 42);
+}
+
+void tst_helpers_hedge::maxAttempts()
+{
+    int calls = 0;
+    auto p = QtPromise::hedge(
+        [&]() {
+            ++calls;
+            return QtPromise::resolve(calls).delay(500);
+        },
+        50,
+        3);
+
+    QCOMPARE(waitForValue(p, -1), 1);
+    QCOMPARE(calls, 3);
+}
+
+void tst_helpers_hedge::cancelAttempts()
+{
+    QFutureInterface<int> iface;
+    iface.reportStarted();
+
+    int calls = 0;
+    auto p = QtPromise::hedge(
+        [&]() {
+            return calls++ == 0 ? QtPromise::resolve(iface.future())
+                                : QtPromise::resolve(42).delay(50);
+        },
+        50,
+        2);
+
+    QCOMPARE(waitForValue(p, -1), 42);
+    QCOMPARE(calls, 2);
+    QCOMPARE(iface.isCanceled(), true);
+
+    iface.reportFinished();
+}
+
+void tst_helpers_hedge::chronoDelay()
+{
+    int calls = 0;
+    auto p = QtPromise::hedge(
+        [&]() {
+            ++calls;
+            return QtPromise::resolve(calls).delay(calls == 1 ? 1000 : 10);
+        },
+        std::chrono::milliseconds{50},
+        2);
+
+    QCOMPARE(waitForValue(p, -1), 2);
+    QCOMPARE(calls, 2);
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtConcurrent>
+#include <QtPromise>
+#include <QtTest>
+
+using namespace QtPromise;
+
+class tst_helpers_latest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void fulfilled();
+    void fulfilled_void();
+    void superseded();
+    void supersededContinuations();
+    void settledNotSuperseded();
+    void rejected();
+    void functorThrows();
+    void cancelFuture();
+};
+
+QTEST_MAIN(tst_helpers_latest)
+#include "tst_latest.moc"
+
+void tst_helpers_latest::fulfilled()
+{
+    auto fn = QtPromise::latest([](const QString& query) {
+        return QtPromise::resolve(query).delay(10);
+    });
+
+    Q_STATIC_ASSERT(
+        (std::is_same<decltype(fn), std::function<QPromise<QString>(const QString&)>>::value));
+
+    QCOMPARE(waitForValue(fn("foo"), QString{}), QString{"foo"});
+    QCOMPARE(waitForValue(fn("bar"), QString{}), QString{"bar"});
+}
+
+void tst_helpers_latest::fulfilled_void()
+{
+    int calls = 0;
+    auto fn = QtPromise::latest([&]() {
+        ++calls;
+    });
+
+    Q_STATIC_ASSERT((std::is_same<decltype(fn), std::function<QPromise<void>()>>::value));
+
+    QCOMPARE(waitForValue(fn(), -1, 42), 42);
+    QCOMPARE(calls, 1);
+}
+
+void tst_helpers_latest::superseded()
+{
+    auto fn = QtPromise::latest([](int value) {
+        return QtPromise::resolve(value).delay(50);
+    });
+
+    auto p0 = fn(42);
+    auto p1 = fn(43);
+    auto p2 = fn(44);
+
+    // Superseded calls are rejected right away.
+    QCOMPARE(p0.isRejected(), true);
+    QCOMPARE(p1.isRejected(), true);
+    QCOMPARE(waitForRejected<QPromiseSupersededException>(p0), true);
+    QCOMPARE(waitForRejected<QPromiseSupersededException>(p1), true);
+    QCOMPARE(waitForValue(p2, -1), 44);
+}
+
+void tst_helpers_latest::supersededContinuations()
+{
+    QVector<int> values;
+    auto fn = QtPromise::latest([](int value) {
+        return QtPromise::resolve(value).delay(10);
+    });
+
+    auto p0 = fn(42).then([&](int value) {
+        values << value;
+    });
+
+    auto p1 = fn(43).then([&](int value) {
+        values << value;
+    });
+
+    QCOMPARE(waitForRejected<QPromiseSupersededException>(p0), true);
+    QCOMPARE(waitForValue(p1, -1, 42), 42);
+    QCOMPARE(values, QVector<int>{43});
+}
+
+void tst_helpers_latest::settledNotSuperseded()
+{
+    auto fn = QtPromise::latest([](int value) {
+        return value;
+    });
+
+    auto p0 = fn(42);
+    QCOMPARE(waitForValue(p0, -1), 42);
+
+    // Settled calls are not affected by the next ones.
+    auto p1 = fn(43);
+    QCOMPARE(p0.isFulfilled(), true);
+    QCOMPARE(waitForValue(p1, -1), 43);
+}
+
+void tst_helpers_latest::rejected()
+{
+    auto fn = QtPromise::latest([](const QString& error) {
+        return QPromise<int>::reject(error).delay(10);
+    });
+
+    QCOMPARE(waitForError(fn("foo"), QString{}), QString{"foo"});
+}
+
+void tst_helpers_latest::functorThrows()
+{
+    auto fn = QtPromise::latest([]() -> int {
+        throw QString{"foo"};
+    });
+
+    QCOMPARE(waitForError(fn(), QString{}), QString{"foo"});
+}
+
+void tst_helpers_latest::cancelFuture()
+{
+    QFutureInterface<int> iface;
+    iface.reportStarted();
+
+    auto fn = QtPromise::latest([&](int value) {
+        if (value == 0) {
+            return QtPromise::resolve(iface.future());
+        }
+        return QtPromise::resolve(value);
+    });
+
+    auto p0 = fn(0);
+    auto p1 = fn(42);
+
+    // The superseded QFuture is canceled.
+    QCOMPARE(iface.isCanceled(), true);
+    QCOMPARE(waitForRejected<QPromiseSupersededException>(p0), true);
+    QCOMPARE(waitForValue(p1, -1), 42);
+
+    iface.reportFinished();
+}
@@ -0,0 +1,350 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/object.h"
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+using namespace QtPromise;
+
+class tst_helpers_listen : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void nextNoArg();
+    void nextOneArg();
+    void nextManyArgs();
+    void nextCount();
+    void nextCountNoArg();
+    void nextCountZero();
+    void disconnect();
+    void senderDestroyed();
+    void sourceDestroyed();
+
+    // QPromiseSignal stream operators
+    void bufferCount();
+    void bufferTime();
+    void bufferClosed();
+    void window();
+    void sample();
+    void scan();
+    void handlerThrows();
+};
+
+QTEST_MAIN(tst_helpers_listen)
+#include "tst_listen.moc"
+
+void tst_helpers_listen::nextNoArg()
+{
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::noArgSignal);
+    Q_STATIC_ASSERT((std::is_same<decltype(source), QPromiseSignal<void>>::value));
+
+    auto p = source.next();
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QPromise<void>>::value));
+    QCOMPARE(p.isPending(), true);
+
+    Q_EMIT sender.noArgSignal();
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+
+    // The connection is kept open for the next emissions.
+    QCOMPARE(source.isActive(), true);
+    QCOMPARE(sender.hasConnections(), true);
+}
+
+void tst_helpers_listen::nextOneArg()
+{
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::oneArgSignal);
+    Q_STATIC_ASSERT((std::is_same<decltype(source), QPromiseSignal<QString>>::value));
+
+    // Emissions are not buffered: only the ones following next() are observed.
+    Q_EMIT sender.oneArgSignal("foo");
+
+    for (int i = 0; i < 3; ++i) {
+        auto p0 = source.next();
+        auto p1 = source.next();
+        Q_EMIT sender.oneArgSignal(QString::number(i));
+        QCOMPARE(waitForValue(p0, QString{}), QString::number(i));
+        QCOMPARE(waitForValue(p1, QString{}), QString::number(i));
+    }
+
+    QCOMPARE(sender.hasConnections(), true);
+}
+
+void tst_helpers_listen::nextManyArgs()
+{
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::twoArgsSignal);
+    Q_STATIC_ASSERT(
+        (std::is_same<decltype(source), QPromiseSignal<std::tuple<int, QString>>>::value));
+
+    auto p0 = source.next();
+    auto p1 = source.next(2);
+    Q_EMIT sender.twoArgsSignal(42, "foo");
+    Q_EMIT sender.twoArgsSignal(43, "bar");
+
+    QCOMPARE(waitForValue(p0, std::make_tuple(-1, QString{})), std::make_tuple(42, QString{"foo"}));
+    QCOMPARE(waitForValue(p1, QVector<std::tuple<int, QString>>{}),
+             (QVector<std::tuple<int, QString>>{std::make_tuple(42, QString{"foo"}),
+                                                std::make_tuple(43, QString{"bar"})}));
+}
+
+void tst_helpers_listen::nextCount()
+{
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::oneArgSignal);
+
+    auto p0 = source.next(3);
+    Q_STATIC_ASSERT((std::is_same<decltype(p0), QPromise<QVector<QString>>>::value));
+
+    Q_EMIT sender.oneArgSignal("foo");
+    auto p1 = source.next(1);
+    auto p2 = source.next();
+    Q_EMIT sender.oneArgSignal("bar");
+    QCOMPARE(p0.isPending(), true);
+    Q_EMIT sender.oneArgSignal("baz");
+
+    QCOMPARE(waitForValue(p0, QVector<QString>{}), (QVector<QString>{"foo", "bar", "baz"}));
+    QCOMPARE(waitForValue(p1, QVector<QString>{}), (QVector<QString>{"bar"}));
+    QCOMPARE(waitForValue(p2, QString{}), QString{"bar"});
+}
+
+void tst_helpers_listen::nextCountNoArg()
+{
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::noArgSignal);
+
+    auto p = source.next(2);
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QPromise<void>>::value));
+
+    Q_EMIT sender.noArgSignal();
+    QCOMPARE(p.isPending(), true);
+    Q_EMIT sender.noArgSignal();
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+}
+
+void tst_helpers_listen::nextCountZero()
+{
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::oneArgSignal);
+
+    auto p = source.next(0);
+    QCOMPARE(p.isFulfilled(), true);
+    QCOMPARE(waitForValue(p, QVector<QString>{"foo"}), QVector<QString>{});
+}
+
+void tst_helpers_listen::disconnect()
+{
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::oneArgSignal);
+
+    auto p0 = source.next();
+    auto p1 = source.next(2);
+    source.disconnect();
+
+    QCOMPARE(source.isActive(), false);
+    QCOMPARE(sender.hasConnections(), false);
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p0), true);
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p1), true);
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(source.next()), true);
+}
+
+void tst_helpers_listen::senderDestroyed()
+{
+    auto sender = new Object{};
+    auto source = QtPromise::listen(sender, &Object::oneArgSignal);
+    auto p = source.next();
+
+    delete sender;
+
+    QCOMPARE(source.isActive(), false);
+    QCOMPARE(waitForRejected<QPromiseContextException>(p), true);
+    QCOMPARE(waitForRejected<QPromiseContextException>(source.next()), true);
+}
+
+void tst_helpers_listen::sourceDestroyed()
+{
+    Object sender;
+    auto p = [&]() {
+        auto source = QtPromise::listen(&sender, &Object::oneArgSignal);
+        return source.next();
+    }();
+
+    // The pending promises don't keep the source alive.
+
+    QCOMPARE(sender.hasConnections(), false);
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p), true);
+}
+
+void tst_helpers_listen::bufferCount()
+{
+    QVector<QVector<QString>> batches;
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::oneArgSignal);
+
+    auto p = source.buffer(2, 0, [&](const QVector<QString>& values) {
+        batches << values;
+    });
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QPromise<void>>::value));
+
+    for (int i = 0; i < 5; ++i) {
+        Q_EMIT sender.oneArgSignal(QString::number(i));
+    }
+
+    QCOMPARE(batches,
+             (QVector<QVector<QString>>{QVector<QString>{"0", "1"}, QVector<QString>{"2", "3"}}));
+    QCOMPARE(p.isPending(), true);
+}
+
+void tst_helpers_listen::bufferTime()
+{
+    QVector<QVector<QString>> batches;
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::oneArgSignal);
+
+    auto p = source.buffer(10, std::chrono::milliseconds{50}, [&](const QVector<QString>& values) {
+        batches << values;
+    });
+
+    Q_EMIT sender.oneArgSignal("foo");
+    Q_EMIT sender.oneArgSignal("bar");
+    QCOMPARE(batches.size(), 0);
+    QTRY_COMPARE(batches, (QVector<QVector<QString>>{QVector<QString>{"foo", "bar"}}));
+
+    Q_EMIT sender.oneArgSignal("baz");
+    QTRY_COMPARE(batches.size(), 2);
+    QCOMPARE(batches.last(), (QVector<QString>{"baz"}));
+    QCOMPARE(p.isPending(), true);
+}
+
+void tst_helpers_listen::bufferClosed()
+{
+    QVector<QVector<QString>> batches;
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::oneArgSignal);
+
+    auto p = source.buffer(10, 0, [&](const QVector<QString>& values) {
+        batches << values;
+    });
+
+    Q_EMIT sender.oneArgSignal("foo");
+    source.disconnect();
+
+    // The last partial batch is delivered before the promise is rejected.
+    QCOMPARE(batches, (QVector<QVector<QString>>{QVector<QString>{"foo"}}));
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p), true);
+
+    // Operators can't be attached to a closed source.
+    auto p1 = source.buffer(1, 0, [](const QVector<QString>&) {});
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p1), true);
+}
+
+void tst_helpers_listen::window()
+{
+    QVector<QVector<QString>> windows;
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::oneArgSignal);
+
+    auto p = source.window(3, 2, [&](const QVector<QString>& values) {
+        windows << values;
+    });
+
+    for (int i = 0; i < 7; ++i) {
+        Q_EMIT sender.oneArgSignal(QString::number(i));
+    }
+
+    QCOMPARE(windows,
+             (QVector<QVector<QString>>{QVector<QString>{"0", "1", "2"},
+                                        QVector<QString>{"2", "3", "4"},
+                                        QVector<QString>{"4", "5", "6"}}));
+    QCOMPARE(p.isPending(), true);
+}
+
+void tst_helpers_listen::sample()
+{
+    QVector<QString> values;
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::oneArgSignal);
+
+    auto p = source.sample(std::chrono::milliseconds{20}, [&](const QString& value) {
+        values << value;
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        Q_EMIT sender.oneArgSignal(QString::number(i));
+    }
+
+    // Only the latest value is delivered, and nothing until the next emission.
+    QTRY_COMPARE(values, QVector<QString>{"9"});
+    QTest::qWait(60);
+    QCOMPARE(values, QVector<QString>{"9"});
+
+    Q_EMIT sender.oneArgSignal("foo");
+    source.disconnect();
+    QCOMPARE(values, (QVector<QString>{"9", "foo"}));
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p), true);
+}
+
+void tst_helpers_listen::scan()
+{
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::oneArgSignal);
+    auto lengths = source.scan(
+        [](int total, const QString& value) {
+            return total + static_cast<int>(value.size());
+        },
+        0);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(lengths), QPromiseSignal<int>>::value));
+
+    auto p0 = lengths.next(3);
+    Q_EMIT sender.oneArgSignal("a");
+    Q_EMIT sender.oneArgSignal("bb");
+    Q_EMIT sender.oneArgSignal("ccc");
+    QCOMPARE(waitForValue(p0, QVector<int>{}), (QVector<int>{1, 3, 6}));
+
+    // The derived source is closed with its upstream source.
+    auto p1 = lengths.next();
+    source.disconnect();
+    QCOMPARE(lengths.isActive(), false);
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p1), true);
+}
+
+void tst_helpers_listen::handlerThrows()
+{
+    int calls = 0;
+    Object sender;
+    auto source = QtPromise::listen(&sender, &Object::oneArgSignal);
+
+    auto p0 = source.buffer(1, 0, [&](const QVector<QString>& values) {
+        ++calls;
+        throw values.first();
+    });
+
+    auto lengths = source.scan(
+        [](int, const QString& value) -> int {
+            throw value;
+        },
+        0);
+
+    auto p1 = lengths.next();
+
+    Q_EMIT sender.oneArgSignal("foo");
+    Q_EMIT sender.oneArgSignal("bar");
+
+    // The source itself is not affected.
+    QCOMPARE(calls, 1);
+    QCOMPARE(source.isActive(), true);
+    QCOMPARE(waitForError(p0, QString{}), QString{"foo"});
+    QCOMPARE(waitForError(p1, QString{}), QString{"foo"});
+    QCOMPARE(lengths.isActive(), false);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+class tst_helpers_match : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void emptySequence();
+    void someMatch();
+    void someMatchShortCircuit();
+    void everyMatch();
+    void everyMatchShortCircuit();
+    void functorThrows();
+};
+
+QTEST_MAIN(tst_helpers_match)
+#include "tst_match.moc"
+
+void tst_helpers_match::emptySequence()
+{
+    auto s = QtPromise::someMatch(QVector<int>{}, [](int, int) {
+        return true;
+    });
+    auto e = QtPromise::everyMatch(QVector<int>{}, [](int, int) {
+        return false;
+    });
+
+    Q_STATIC_ASSERT((std::is_same<decltype(s), QtPromise::QPromise<bool>>::value));
+    Q_STATIC_ASSERT((std::is_same<decltype(e), QtPromise::QPromise<bool>>::value));
+    QCOMPARE(waitForValue(s, true), false);
+    QCOMPARE(waitForValue(e, false), true);
+}
+
+void tst_helpers_match::someMatch()
+{
+    auto fn = [](int v, int) {
+        return QtPromise::resolve(v > 2).delay(10);
+    };
+
+    QCOMPARE(waitForValue(QtPromise::someMatch(QVector<int>{1, 2, 3}, fn), false), true);
+    QCOMPARE(waitForValue(QtPromise::someMatch(QVector<int>{1, 2}, fn), true), false);
+}
+
+void tst_helpers_match::someMatchShortCircuit()
+{
+    // The first match (in completion order) answers, remaining values are not evaluated.
+    QVector<int> calls;
+    auto p = QtPromise::someMatch(
+        QVector<int>{200, 10, 200, 200},
+        [&](int v, int i) {
+            calls << i;
+            return QtPromise::resolve(v == 10).delay(v);
+        },
+        2);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QCOMPARE(waitForValue(p, false), true);
+    QCOMPARE(calls, (QVector<int>{0, 1}));
+    QVERIFY(timer.elapsed() < 150);
+}
+
+void tst_helpers_match::everyMatch()
+{
+    auto fn = [](int v, int) {
+        return QtPromise::resolve(v > 0).delay(10);
+    };
+
+    QCOMPARE(waitForValue(QtPromise::everyMatch(QVector<int>{1, 2, 3}, fn), false), true);
+    QCOMPARE(waitForValue(QtPromise::everyMatch(QVector<int>{1, 0, 3}, fn), true), false);
+}
+
+void tst_helpers_match::everyMatchShortCircuit()
+{
+    QVector<int> calls;
+    auto p = QtPromise::everyMatch(QVector<int>{1, 0, 3, 4}, [&](int v, int i) {
+        calls << i;
+        return v > 0;
+    });
+
+    QCOMPARE(waitForValue(p, true), false);
+    QCOMPARE(calls, (QVector<int>{0, 1}));
+}
+
+void tst_helpers_match::functorThrows()
+{
+    auto p = QtPromise::everyMatch(QVector<int>{1, 2, 3}, [](int v, int) -> bool {
+        if (v == 2) {
+            throw QString{"foo"};
+        }
+        return true;
+    });
+
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+}
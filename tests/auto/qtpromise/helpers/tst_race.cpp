@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+class tst_helpers_race : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void emptySequence();
+    void emptySequence_void();
+    void firstFulfilled();
+    void firstFulfilled_void();
+    void firstRejected();
+    void firstRejected_void();
+    void alreadySettled();
+    void cancelLosers();
+    void keepObservedLosers();
+    void sequenceTypes();
+};
+
+QTEST_MAIN(tst_helpers_race)
+#include "tst_race.moc"
+
+void tst_helpers_race::emptySequence()
+{
+    auto p = QtPromise::race(QVector<QtPromise::QPromise<int>>{});
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<int>>::value));
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(waitForRejected<QtPromise::QPromiseUndefinedException>(p), true);
+}
+
+void tst_helpers_race::emptySequence_void()
+{
+    auto p = QtPromise::race(QVector<QtPromise::QPromise<void>>{});
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<void>>::value));
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(waitForRejected<QtPromise::QPromiseUndefinedException>(p), true);
+}
+
+void tst_helpers_race::firstFulfilled()
+{
+    auto p0 = QtPromise::resolve(42).delay(500);
+    auto p1 = QtPromise::resolve(43).delay(100);
+    auto p2 = QtPromise::QPromise<int>{
+        [](const QtPromise::QPromiseResolve<int>&, const QtPromise::QPromiseReject<int>& reject) {
+            QTimer::singleShot(250, [=]() {
+                reject(QString{"foo"});
+            });
+        }};
+
+    auto p = QtPromise::race(QVector<QtPromise::QPromise<int>>{p0, p1, p2});
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<int>>::value));
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForValue(p, -1), 43);
+    QCOMPARE(p0.isPending(), true);
+    QCOMPARE(p2.isPending(), true);
+}
+
+void tst_helpers_race::firstFulfilled_void()
+{
+    auto p0 = QtPromise::resolve().delay(500);
+    auto p1 = QtPromise::resolve().delay(100);
+
+    auto p = QtPromise::race(QVector<QtPromise::QPromise<void>>{p0, p1});
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<void>>::value));
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+    QCOMPARE(p0.isPending(), true);
+}
+
+void tst_helpers_race::firstRejected()
+{
+    auto p0 = QtPromise::resolve(42).delay(500);
+    auto p1 = QtPromise::QPromise<int>{
+        [](const QtPromise::QPromiseResolve<int>&, const QtPromise::QPromiseReject<int>& reject) {
+            QtPromisePrivate::qtpromise_defer([=]() {
+                reject(QString{"foo"});
+            });
+        }};
+
+    auto p = QtPromise::race(QVector<QtPromise::QPromise<int>>{p0, p1});
+
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+    QCOMPARE(p0.isPending(), true);
+}
+
+void tst_helpers_race::firstRejected_void()
+{
+    auto p0 = QtPromise::resolve().delay(500);
+    auto p1 = QtPromise::QPromise<void>{
+        [](const QtPromise::QPromiseResolve<void>&, const QtPromise::QPromiseReject<void>& reject) {
+            QtPromisePrivate::qtpromise_defer([=]() {
+                reject(QString{"foo"});
+            });
+        }};
+
+    auto p = QtPromise::race(QVector<QtPromise::QPromise<void>>{p0, p1});
+
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+    QCOMPARE(p0.isPending(), true);
+}
+
+void tst_helpers_race::alreadySettled()
+{
+    auto p0 = QtPromise::resolve(42).delay(100);
+    auto p1 = QtPromise::resolve(43);
+    auto p2 = QtPromise::resolve(44);
+
+    auto p = QtPromise::race(QVector<QtPromise::QPromise<int>>{p0, p1, p2});
+
+    // Callbacks are always called asynchronously, in registration order.
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForValue(p, -1), 43);
+}
+
+void tst_helpers_race::cancelLosers()
+{
+    QFutureInterface<int> iface;
+    iface.reportStarted();
+
+    auto p0 = QtPromise::resolve(iface.future());
+    auto p1 = QtPromise::resolve(42).delay(100);
+
+    auto p = QtPromise::race(QVector<QtPromise::QPromise<int>>{p0, p1});
+
+    QCOMPARE(waitForValue(p, -1), 42);
+    QCOMPARE(iface.isCanceled(), true);
+
+    iface.reportFinished();
+
+    QCOMPARE(waitForRejected<QtPromise::QPromiseCanceledException>(p0), true);
+}
+
+void tst_helpers_race::keepObservedLosers()
+{
+    QFutureInterface<int> iface;
+    iface.reportStarted();
+
+    int value = -1;
+    auto p0 = QtPromise::resolve(iface.future());
+    p0.then([&](int res) {
+        value = res;
+    });
+
+    auto p1 = QtPromise::resolve(42).delay(100);
+    auto p = QtPromise::race(QVector<QtPromise::QPromise<int>>{p0, p1});
+
+    QCOMPARE(waitForValue(p, -1), 42);
+    QCOMPARE(iface.isCanceled(), false);
+
+    iface.reportResult(43);
+    iface.reportFinished();
+
+    QCOMPARE(waitForValue(p0, -1), 43);
+    QCOMPARE(value, 43);
+}
+
+void tst_helpers_race::sequenceTypes()
+{
+    auto p0 = QtPromise::resolve(42).delay(100);
+    auto p1 = QtPromise::resolve(43).delay(200);
+
+    QCOMPARE(waitForValue(QtPromise::race(QList<QtPromise::QPromise<int>>{p0, p1}), -1), 42);
+    QCOMPARE(waitForValue(QtPromise::race(std::list<QtPromise::QPromise<int>>{p1, p0}), -1), 42);
+    QCOMPARE(waitForValue(QtPromise::race(std::vector<QtPromise::QPromise<int>>{p1, p0}), -1), 42);
+}
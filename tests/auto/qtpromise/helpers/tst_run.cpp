@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+using namespace QtPromise;
+
+class tst_helpers_run : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void value();
+    void value_void();
+    void promise();
+    void rejected();
+    void threadPool();
+    void executor();
+    void priority();
+    void poolDestroyed();
+    void settledFromWorker();
+    void canceled();
+};
+
+QTEST_MAIN(tst_helpers_run)
+#include "tst_run.moc"
+
+void tst_helpers_run::value()
+{
+    QThreadPool pool;
+    std::atomic<QThread*> target{nullptr};
+
+    auto p = QtPromise::run(
+        &pool,
+        [&](int a, const QString& b) {
+            target = QThread::currentThread();
+            return a + static_cast<int>(b.size());
+        },
+        40,
+        QString{"42"});
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QPromise<int>>::value));
+
+    QCOMPARE(waitForValue(p, -1), 42);
+    QVERIFY(target.load() != nullptr);
+    QVERIFY(target.load() != QThread::currentThread());
+}
+
+void tst_helpers_run::value_void()
+{
+    QThreadPool pool;
+    std::atomic<int> calls{0};
+
+    auto p = QtPromise::run(&pool, [&]() {
+        ++calls;
+    });
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QPromise<void>>::value));
+
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+    QCOMPARE(calls.load(), 1);
+}
+
+void tst_helpers_run::promise()
+{
+    QThreadPool pool;
+
+    auto p = QtPromise::run(
+        &pool,
+        [](int value) {
+            return QtPromise::resolve(value + 1);
+        },
+        41);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QPromise<int>>::value));
+
+    QCOMPARE(waitForValue(p, -1), 42);
+}
+
+void tst_helpers_run::rejected()
+{
+    QThreadPool pool;
+
+    auto p = QtPromise::run(&pool, []() {
+        throw QString{"foo"};
+        return 42;
+    });
+
+    // The exception thrown by the worker is forwarded as-is (not as QUnhandledException).
+    QCOMPARE(waitForError(p, QString{}), QString{"foo"});
+}
+
+void tst_helpers_run::threadPool()
+{
+    QPromiseThreadPool pool{2};
+
+    auto p = QtPromise::run(
+        pool,
+        [](int value) {
+            return value + 1;
+        },
+        41);
+
+    QCOMPARE(waitForValue(p, -1), 42);
+}
+
+void tst_helpers_run::executor()
+{
+    int calls = 0;
+    QPromiseExecutor executor{[&](std::function<void()> fn) {
+        ++calls;
+        QtPromisePrivate::qtpromise_defer(std::move(fn));
+    }};
+
+    auto p = QtPromise::run(
+        executor,
+        [](int value) {
+            return value + 1;
+        },
+        41);
+
+    QCOMPARE(waitForValue(p, -1), 42);
+    QCOMPARE(calls, 1);
+}
+
+void tst_helpers_run::priority()
+{
+    QThreadPool pool;
+    pool.setMaxThreadCount(1);
+
+    std::atomic<bool> blocking{false};
+    std::atomic<bool> release{false};
+    std::mutex mutex;
+    QVector<int> order;
+
+    // Saturates the single thread of the pool so that the next tasks are queued.
+    auto p0 = QtPromise::run(&pool, [&]() {
+        blocking = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+
+    QTRY_COMPARE(blocking.load(), true);
+
+    QVector<QPromise<void>> promises{p0};
+    for (int priority : {1, 3, 2}) {
+        promises << QtPromise::run(QPromiseExecutor::pool(&pool, priority), [&, priority]() {
+            std::lock_guard<std::mutex> lock{mutex};
+            order << priority;
+        });
+    }
+
+    release = true;
+
+    // The queued tasks are run by decreasing priority.
+    QCOMPARE(waitForValue(QtPromise::all(promises), -1, 42), 42);
+    QCOMPARE(order, (QVector<int>{3, 2, 1}));
+}
+
+void tst_helpers_run::poolDestroyed()
+{
+    auto pool = new QThreadPool{};
+    auto executor = QPromiseExecutor::pool(pool);
+    delete pool;
+    int calls = 0;
+
+    auto p = QtPromise::run(executor, [&]() {
+        ++calls;
+        return 42;
+    });
+
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p), true);
+    QCOMPARE(calls, 0);
+}
+
+void tst_helpers_run::settledFromWorker()
+{
+    QPromiseThreadPool pool{1};
+    std::atomic<bool> release{false};
+    std::thread::id worker;
+    std::thread::id target;
+
+    // The promise is settled by the worker, so an immediate continuation is called there.
+    auto p0 = QtPromise::run(pool, [&]() {
+        worker = std::this_thread::get_id();
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+
+    auto p1 = p0.then(QPromiseExecutor::immediate(), [&]() {
+        target = std::this_thread::get_id();
+    });
+
+    release = true;
+
+    QCOMPARE(waitForValue(p1, -1, 42), 42);
+    QCOMPARE(target == worker, true);
+}
+
+void tst_helpers_run::canceled()
+{
+    std::atomic<bool> blocking{false};
+    std::atomic<bool> release{false};
+    std::atomic<int> calls{0};
+    QPromiseThreadPool pool{1};
+
+    pool.start([&]() {
+        blocking = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+
+    QTRY_COMPARE(blocking.load(), true);
+
+    auto p = QtPromise::run(pool, [&]() {
+        ++calls;
+        return 42;
+    });
+
+    // Losing the race cancels the promise while its task is still queued.
+    QCOMPARE(waitForValue(QtPromise::race(QVector<QPromise<int>>{p, QtPromise::resolve(43)}), -1),
+             43);
+
+    release = true;
+
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p), true);
+    QCOMPARE(calls.load(), 0);
+}
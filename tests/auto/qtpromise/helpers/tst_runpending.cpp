@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+class tst_helpers_runpending : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void cleanup();
+
+    void eventLoop();
+    void threadPool();
+    void threadPoolEventLoop();
+    void manual();
+    void maxItems();
+    void timeBudget();
+    void queuedMeanwhile();
+    void wait();
+    void stdChrono();
+};
+
+QTEST_MAIN(tst_helpers_runpending)
+#include "tst_runpending.moc"
+
+namespace {
+
+// QThreadPool::start(std::function) requires Qt 5.15.
+class Task : public QRunnable
+{
+public:
+    explicit Task(std::function<void()> fn) : m_fn{std::move(fn)} { }
+    void run() Q_DECL_OVERRIDE { m_fn(); }
+
+private:
+    std::function<void()> m_fn;
+};
+
+} // anonymous namespace
+
+void tst_helpers_runpending::cleanup()
+{
+    QtPromise::setDispatchMode(QtPromise::DispatchMode::EventLoop);
+    QtPromise::runPending();
+}
+
+void tst_helpers_runpending::eventLoop()
+{
+    int value = -1;
+
+    QCOMPARE(QtPromise::dispatchMode(), QtPromise::DispatchMode::EventLoop);
+
+    auto p = QtPromise::resolve(42).then([&](int res) {
+        value = res;
+    });
+
+    QCOMPARE(QtPromise::runPending(), 0);
+    QCOMPARE(value, -1);
+
+    QCoreApplication::processEvents();
+    QCOMPARE(value, 42);
+}
+
+void tst_helpers_runpending::threadPool()
+{
+    QThreadPool pool;
+    std::atomic<bool> done{false};
+    std::atomic<int> count{-1};
+    std::atomic<int> value{-1};
+    std::atomic<bool> fulfilled{false};
+
+    // Pool workers have an event dispatcher but never run their event loop, so continuations
+    // registered from a task are queued and called by the task itself.
+    pool.start(new Task{[&]() {
+        auto p = QtPromise::resolve(42).then([&](int res) {
+            value = res;
+        });
+
+        count = QtPromise::runPending();
+        fulfilled = p.isFulfilled();
+        done = true;
+    }});
+
+    QTRY_COMPARE(done.load(), true);
+    QCOMPARE(count.load(), 1);
+    QCOMPARE(value.load(), 42);
+    QCOMPARE(fulfilled.load(), true);
+}
+
+void tst_helpers_runpending::threadPoolEventLoop()
+{
+    QThreadPool pool;
+    std::atomic<bool> done{false};
+    std::atomic<int> calls{0};
+    std::atomic<int> count{-1};
+
+    // If the task runs an event loop after all, the queued continuations are called by it,
+    // each a single time.
+    pool.start(new Task{[&]() {
+        for (int i = 0; i < 3; ++i) {
+            QtPromise::resolve(42).then([&]() {
+                ++calls;
+            });
+        }
+
+        QCoreApplication::processEvents();
+        count = QtPromise::runPending();
+        done = true;
+    }});
+
+    QTRY_COMPARE(done.load(), true);
+    QCOMPARE(calls.load(), 3);
+    QCOMPARE(count.load(), 0);
+}
+
+void tst_helpers_runpending::manual()
+{
+    int value = -1;
+
+    QtPromise::setDispatchMode(QtPromise::DispatchMode::Manual);
+    QCOMPARE(QtPromise::dispatchMode(), QtPromise::DispatchMode::Manual);
+
+    auto p = QtPromise::resolve(42).then([&](int res) {
+        value = res;
+    });
+
+    // Continuations are not posted to the event loop anymore.
+    QCoreApplication::processEvents();
+    QCOMPARE(value, -1);
+    QCOMPARE(p.isPending(), true);
+
+    QCOMPARE(QtPromise::runPending(), 1);
+    QCOMPARE(value, 42);
+    QCOMPARE(p.isFulfilled(), true);
+    QCOMPARE(QtPromise::runPending(), 0);
+}
+
+void tst_helpers_runpending::maxItems()
+{
+    QVector<int> values;
+
+    QtPromise::setDispatchMode(QtPromise::DispatchMode::Manual);
+
+    for (int i = 0; i < 5; ++i) {
+        QtPromise::resolve(i).then([&](int res) {
+            values << res;
+        });
+    }
+
+    QCOMPARE(QtPromise::runPending(2), 2);
+    QCOMPARE(values, (QVector<int>{0, 1}));
+    QCOMPARE(QtPromise::runPending(0), 0);
+    QCOMPARE(QtPromise::runPending(), 3);
+    QCOMPARE(values, (QVector<int>{0, 1, 2, 3, 4}));
+}
+
+void tst_helpers_runpending::timeBudget()
+{
+    int calls = 0;
+
+    QtPromise::setDispatchMode(QtPromise::DispatchMode::Manual);
+
+    for (int i = 0; i < 10; ++i) {
+        QtPromise::resolve(i).then([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds{20});
+            ++calls;
+        });
+    }
+
+    // The budget is checked after each continuation, so at least one is called.
+    QCOMPARE(QtPromise::runPending(-1, 1), 1);
+    QCOMPARE(calls, 1);
+
+    // Each continuation takes at least 20ms, so no more than 3 fit in the budget.
+    const int count = QtPromise::runPending(-1, 50);
+    QVERIFY(count >= 1);
+    QVERIFY(count <= 3);
+    QCOMPARE(calls, count + 1);
+
+    // A budget which is not positive is unlimited.
+    QCOMPARE(QtPromise::runPending(-1, 0), 9 - count);
+    QCOMPARE(calls, 10);
+}
+
+void tst_helpers_runpending::queuedMeanwhile()
+{
+    QVector<int> values;
+
+    QtPromise::setDispatchMode(QtPromise::DispatchMode::Manual);
+
+    QtPromise::resolve(1)
+        .then([&](int res) {
+            values << res;
+            return res + 1;
+        })
+        .then([&](int res) {
+            values << res;
+        });
+
+    QCOMPARE(QtPromise::runPending(), 2);
+    QCOMPARE(values, (QVector<int>{1, 2}));
+}
+
+void tst_helpers_runpending::wait()
+{
+    QtPromise::setDispatchMode(QtPromise::DispatchMode::Manual);
+
+    // Waiting for a promise calls the pending continuations it depends on.
+    auto p = QtPromise::resolve(42).delay(50).then([](int res) {
+        return res + 1;
+    });
+
+    QCOMPARE(p.waitFor(5000), QtPromise::WaitStatus::Fulfilled);
+    QCOMPARE(p.isFulfilled(), true);
+}
+
+void tst_helpers_runpending::stdChrono()
+{
+    int calls = 0;
+
+    QtPromise::setDispatchMode(QtPromise::DispatchMode::Manual);
+
+    for (int i = 0; i < 6; ++i) {
+        QtPromise::resolve(i).then([&]() {
+            ++calls;
+        });
+    }
+
+    QCOMPARE(QtPromise::runPending(2, std::chrono::seconds{1}), 2);
+    QCOMPARE(QtPromise::runPending(2, std::chrono::milliseconds::max()), 2);
+    QCOMPARE(QtPromise::runPending(-1, std::chrono::milliseconds{-1}), 2);
+    QCOMPARE(calls, 6);
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+class tst_helpers_some : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void emptyQuorum();
+    void emptyQuorum_void();
+    void quorumTooLarge();
+    void quorumTooLarge_void();
+    void quorumFulfilled();
+    void quorumFulfilled_void();
+    void quorumImpossible();
+    void quorumImpossible_void();
+    void cancelRemaining();
+    void sequenceTypes();
+};
+
+QTEST_MAIN(tst_helpers_some)
+#include "tst_some.moc"
+
+void tst_helpers_some::emptyQuorum()
+{
+    auto p = QtPromise::some(QVector<QtPromise::QPromise<int>>{QtPromise::resolve(42)}, 0);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<QVector<int>>>::value));
+    QCOMPARE(waitForValue(p, QVector<int>{}), QVector<int>{});
+}
+
+void tst_helpers_some::emptyQuorum_void()
+{
+    auto p = QtPromise::some(QVector<QtPromise::QPromise<void>>{}, 0);
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<void>>::value));
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+}
+
+void tst_helpers_some::quorumTooLarge()
+{
+    auto p = QtPromise::some(QVector<QtPromise::QPromise<int>>{QtPromise::resolve(42)}, 2);
+
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(waitForRejected<QtPromise::QPromiseAggregateException>(p), true);
+}
+
+void tst_helpers_some::quorumTooLarge_void()
+{
+    auto p = QtPromise::some(QVector<QtPromise::QPromise<void>>{QtPromise::resolve()}, 2);
+
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(waitForRejected<QtPromise::QPromiseAggregateException>(p), true);
+}
+
+void tst_helpers_some::quorumFulfilled()
+{
+    auto p0 = QtPromise::resolve(42).delay(1000);
+    auto p1 = QtPromise::resolve(43).delay(100);
+    auto p2 = rejectLater<int>(10, "foo");
+    auto p3 = QtPromise::resolve(44).delay(50);
+
+    auto p = QtPromise::some(QVector<QtPromise::QPromise<int>>{p0, p1, p2, p3}, 2);
+
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForValue(p, QVector<int>{}), (QVector<int>{44, 43}));
+    QCOMPARE(p0.isPending(), true);
+}
+
+void tst_helpers_some::quorumFulfilled_void()
+{
+    auto p0 = QtPromise::resolve().delay(1000);
+    auto p1 = QtPromise::resolve().delay(100);
+    auto p2 = QtPromise::resolve().delay(50);
+
+    auto p = QtPromise::some(QVector<QtPromise::QPromise<void>>{p0, p1, p2}, 2);
+
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForValue(p, -1, 42), 42);
+    QCOMPARE(p0.isPending(), true);
+}
+
+void tst_helpers_some::quorumImpossible()
+{
+    auto p0 = QtPromise::resolve(42).delay(1000);
+    auto p1 = rejectLater<int>(100, "foo");
+    auto p2 = rejectLater<int>(50, "bar");
+
+    auto p = QtPromise::some(QVector<QtPromise::QPromise<int>>{p0, p1, p2}, 2);
+    auto e = waitForError(p, QtPromise::QPromiseAggregateException{});
+
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(e.errors().size(), 2);
+    QCOMPARE(p0.isPending(), true);
+}
+
+void tst_helpers_some::quorumImpossible_void()
+{
+    auto p0 = QtPromise::resolve().delay(1000);
+    auto p1 = rejectLater<void>(50, "foo");
+
+    auto p = QtPromise::some(QVector<QtPromise::QPromise<void>>{p0, p1}, 2);
+    auto e = waitForError(p, QtPromise::QPromiseAggregateException{});
+
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(e.errors().size(), 1);
+    QCOMPARE(p0.isPending(), true);
+}
+
+void tst_helpers_some::cancelRemaining()
+{
+    QFutureInterface<int> iface;
+    iface.reportStarted();
+
+    auto p0 = QtPromise::resolve(iface.future());
+    auto p1 = QtPromise::resolve(42).delay(50);
+    auto p2 = QtPromise::resolve(43).delay(100);
+
+    auto p = QtPromise::some(QVector<QtPromise::QPromise<int>>{p0, p1, p2}, 2);
+
+    QCOMPARE(waitForValue(p, QVector<int>{}), (QVector<int>{42, 43}));
+    QCOMPARE(iface.isCanceled(), true);
+
+    iface.reportFinished();
+
+    QCOMPARE(waitForRejected<QtPromise::QPromiseCanceledException>(p0), true);
+}
+
+void tst_helpers_some::sequenceTypes()
+{
+    auto p0 = QtPromise::resolve(42).delay(100);
+    auto p1 = QtPromise::resolve(43).delay(50);
+
+    QCOMPARE(waitForValue(QtPromise::some(QList<QtPromise::QPromise<int>>{p0, p1}, 1),
+                          QVector<int>{}),
+             QVector<int>{43});
+    QCOMPARE(waitForValue(QtPromise::some(std::list<QtPromise::QPromise<int>>{p0, p1}, 1),
+                          QVector<int>{}),
+             QVector<int>{43});
+    QCOMPARE(waitForValue(QtPromise::some(std::vector<QtPromise::QPromise<int>>{p0, p1}, 2),
+                          QVector<int>{}),
+             (QVector<int>{43, 42}));
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+#include <chrono>
+
+using namespace QtPromise;
+
+class tst_helpers_throttle : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void leadingCall();
+    void trailingCall();
+    void trailingCall_void();
+    void windowClosed();
+    void functorThrows();
+};
+
+QTEST_MAIN(tst_helpers_throttle)
+#include "tst_throttle.moc"
+
+void tst_helpers_throttle::leadingCall()
+{
+    QStringList values;
+    auto fn = QtPromise::throttle(
+        [&](const QString& value) {
+            values << value;
+            return value;
+        },
+        50);
+
+    Q_STATIC_ASSERT(
+        (std::is_same<decltype(fn), std::function<QPromise<QString>(const QString&)>>::value));
+
+    // The first call is executed right away.
+    auto p = fn("foo");
+    QCOMPARE(values, QStringList{"foo"});
+    QCOMPARE(waitForValue(p, QString{}), QString{"foo"});
+}
+
+void tst_helpers_throttle::trailingCall()
+{
+    QStringList values;
+    auto fn = QtPromise::throttle(
+        [&](const QString& value) {
+            values << value;
+            return value;
+        },
+        50);
+
+    auto p0 = fn("foo");
+    auto p1 = fn("bar");
+    auto p2 = fn("baz");
+
+    // Calls made during the window are coalesced onto a single (trailing) call.
+    QCOMPARE(values, QStringList{"foo"});
+    QCOMPARE(waitForValue(p0, QString{}), QString{"foo"});
+    QCOMPARE(waitForValue(p1, QString{}), QString{"baz"});
+    QCOMPARE(waitForValue(p2, QString{}), QString{"baz"});
+    QCOMPARE(values, (QStringList{"foo", "baz"}));
+}
+
+void tst_helpers_throttle::trailingCall_void()
+{
+    int calls = 0;
+    auto fn = QtPromise::throttle(
+        [&]() {
+            ++calls;
+        },
+        std::chrono::milliseconds{50});
+
+    Q_STATIC_ASSERT((std::is_same<decltype(fn), std::function<QPromise<void>()>>::value));
+
+    fn();
+    auto p0 = fn();
+    auto p1 = fn();
+
+    QCOMPARE(calls, 1);
+    QCOMPARE(waitForValue(p0, -1, 42), 42);
+    QCOMPARE(waitForValue(p1, -1, 42), 42);
+    QCOMPARE(calls, 2);
+}
+
+void tst_helpers_throttle::windowClosed()
+{
+    int calls = 0;
+    auto fn = QtPromise::throttle(
+        [&]() {
+            return ++calls;
+        },
+        50);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    fn();
+    auto p0 = fn();
+    QCOMPARE(waitForValue(p0, -1), 2);
+
+    // The trailing call opened a new window.
+    auto p1 = fn();
+    QCOMPARE(calls, 2);
+    QCOMPARE(waitForValue(p1, -1), 3);
+    QVERIFY(timer.elapsed() >= 90);
+
+    // No call has been made during the last window, so it's closed.
+    QTest::qWait(100);
+    auto p2 = fn();
+    QCOMPARE(calls, 4);
+    QCOMPARE(p2.isFulfilled(), true);
+}
+
+void tst_helpers_throttle::functorThrows()
+{
+    auto fn = QtPromise::throttle(
+        [&]() -> int {
+            throw QString{"foo"};
+        },
+        10);
+
+    auto p0 = fn();
+    auto p1 = fn();
+
+    QCOMPARE(waitForError(p0, QString{}), QString{"foo"});
+    QCOMPARE(waitForError(p1, QString{}), QString{"foo"});
+}
@@ -11,6 +11,7 @@
 #include <QtTest>
 
 #include <chrono>
+#include <thread>
 
 class tst_qpromise_delay : public QObject
 {
@@ -19,6 +20,8 @@ class tst_qpromise_delay : public QObject
 private Q_SLOTS:
     void fulfilled();
     void rejected();
+    void ordering();
+    void noEventLoop();
 
     void fulfilledStdChrono();
     void rejectedStdChrono();
@@ -64,6 +67,46 @@ void tst_qpromise_delay::rejected()
     QVERIFY(elapsed <= 10);
 }
 
+void tst_qpromise_delay::ordering()
+{
+    QVector<int> values;
+    QVector<QtPromise::QPromise<int>> promises;
+
+    // Delays spread across several levels of the underlying timer wheel.
+    for (int msec : {300, 70, 5, 0}) {
+        promises << QtPromise::resolve(msec).delay(msec).tap([&](int value) {
+            values << value;
+        });
+    }
+
+    QtPromise::all(promises).wait();
+
+    QCOMPARE(values, (QVector<int>{0, 5, 70, 300}));
+}
+
+void tst_qpromise_delay::noEventLoop()
+{
+    QVector<int> values;
+    QtPromise::WaitStatus status = QtPromise::WaitStatus::Timeout;
+
+    // Threads without event dispatcher expire their timers while waiting.
+    std::thread thread{[&]() {
+        QVector<QtPromise::QPromise<int>> promises;
+        for (int msec : {100, 70, 5}) {
+            promises << QtPromise::resolve(msec).delay(msec).tap([&](int value) {
+                values << value;
+            });
+        }
+
+        status = QtPromise::all(promises).waitFor(5000);
+    }};
+
+    thread.join();
+
+    QCOMPARE(status, QtPromise::WaitStatus::Fulfilled);
+    QCOMPARE(values, (QVector<int>{5, 70, 100}));
+}
+
 void tst_qpromise_delay::fulfilledStdChrono()
 {
     QElapsedTimer timer;
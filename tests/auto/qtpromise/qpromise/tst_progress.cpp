@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+#include <atomic>
+#include <thread>
+
+using namespace QtPromise;
+
+class tst_qpromise_progress : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void reported();
+    void coalesced();
+    void interval();
+    void fromThread();
+    void settled();
+    void settledWhilePending();
+    void settledWhileReporting();
+    void returnsSamePromise();
+    void future();
+};
+
+QTEST_MAIN(tst_qpromise_progress)
+#include "tst_progress.moc"
+
+namespace {
+
+struct Reporter
+{
+    std::function<void(int, int)> report;
+    std::function<void(int)> resolve;
+
+    QPromise<int> promise()
+    {
+        return QPromise<int>{[&](const QPromiseResolve<int>& res,
+                                 const QPromiseReject<int>&,
+                                 const QPromiseProgress<int>& progress) {
+            report = progress;
+            resolve = res;
+        }};
+    }
+};
+
+} // anonymous namespace
+
+void tst_qpromise_progress::reported()
+{
+    Reporter reporter;
+    QVector<int> values;
+    int maximum = -1;
+
+    auto p = reporter.promise().progress([&](int value, int max) {
+        values << value;
+        maximum = max;
+    });
+
+    reporter.report(4, 10);
+
+    // Delivered asynchronously, even when reported from the listener thread.
+    QCOMPARE(values, QVector<int>{});
+    QTRY_COMPARE(values, (QVector<int>{4}));
+    QCOMPARE(maximum, 10);
+
+    reporter.resolve(42);
+    QCOMPARE(waitForValue(p, -1), 42);
+}
+
+void tst_qpromise_progress::coalesced()
+{
+    Reporter reporter;
+    QVector<int> values;
+
+    auto p = reporter.promise().progress([&](int value, int) {
+        values << value;
+    });
+
+    for (int i = 1; i <= 100; ++i) {
+        reporter.report(i, 100);
+    }
+
+    // Only the last reported value is delivered.
+    QTRY_COMPARE(values, (QVector<int>{100}));
+
+    reporter.report(101, 100);
+    reporter.report(102, 100);
+    QTRY_COMPARE(values, (QVector<int>{100, 102}));
+
+    reporter.resolve(42);
+    QCOMPARE(waitForValue(p, -1), 42);
+}
+
+void tst_qpromise_progress::interval()
+{
+    Reporter reporter;
+    QVector<int> values;
+    QElapsedTimer timer;
+    qint64 elapsed = -1;
+
+    auto p = reporter.promise().progress(
+        [&](int value, int) {
+            values << value;
+            if (values.size() == 2) {
+                elapsed = timer.elapsed();
+            }
+        },
+        std::chrono::milliseconds{200});
+
+    timer.start();
+    reporter.report(1, 10);
+    QTRY_COMPARE(values, (QVector<int>{1}));
+
+    reporter.report(2, 10);
+    reporter.report(3, 10);
+    QTRY_COMPARE(values, (QVector<int>{1, 3}));
+    QVERIFY(elapsed >= 190);
+
+    reporter.resolve(42);
+    QCOMPARE(waitForValue(p, -1), 42);
+}
+
+void tst_qpromise_progress::fromThread()
+{
+    Reporter reporter;
+    QVector<int> values;
+    QThread* target = nullptr;
+
+    auto p = reporter.promise().progress([&](int value, int) {
+        values << value;
+        target = QThread::currentThread();
+    });
+
+    std::thread([&]() {
+        for (int i = 1; i <= 10; ++i) {
+            reporter.report(i, 10);
+        }
+    }).join();
+
+    QTRY_COMPARE(values.isEmpty() ? -1 : values.last(), 10);
+    QVERIFY(values.size() <= 10);
+    QCOMPARE(target, QThread::currentThread());
+
+    reporter.resolve(42);
+    QCOMPARE(waitForValue(p, -1), 42);
+}
+
+void tst_qpromise_progress::settled()
+{
+    Reporter reporter;
+    int calls = 0;
+
+    auto p = reporter.promise().progress([&](int, int) {
+        ++calls;
+    });
+
+    reporter.resolve(42);
+    reporter.report(1, 10);
+    QCOMPARE(waitForValue(p, -1), 42);
+
+    // Listeners registered after the promise is settled are never called.
+    QtPromise::resolve(42).progress([&](int, int) {
+        ++calls;
+    });
+
+    QCoreApplication::processEvents();
+    QCOMPARE(calls, 0);
+}
+
+void tst_qpromise_progress::settledWhilePending()
+{
+    Reporter reporter;
+    int calls = 0;
+
+    auto p = reporter.promise().progress([&](int, int) {
+        ++calls;
+    });
+
+    // Not delivered yet when settled, thus never delivered (i.e. not after the handlers).
+    reporter.report(1, 10);
+    reporter.resolve(42);
+    QCOMPARE(waitForValue(p, -1), 42);
+
+    QCoreApplication::processEvents();
+    QCOMPARE(calls, 0);
+}
+
+void tst_qpromise_progress::settledWhileReporting()
+{
+    Reporter reporter;
+    std::atomic<bool> started{false};
+    std::atomic<bool> stop{false};
+
+    auto p = reporter.promise().progress([](int, int) {});
+
+    auto report = reporter.report;
+    std::thread thread{[&]() {
+        for (int i = 0; !stop; ++i) {
+            report(i % 100, 100);
+            started = true;
+        }
+    }};
+
+    // Settling the promise while progress is reported from another thread.
+    QTRY_COMPARE(started.load(), true);
+    reporter.resolve(42);
+    stop = true;
+    thread.join();
+
+    QCOMPARE(waitForValue(p, -1), 42);
+}
+
+void tst_qpromise_progress::returnsSamePromise()
+{
+    auto p0 = QtPromise::resolve(42);
+    auto p1 = p0.progress([](int, int) {});
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p1), QPromise<int>>::value));
+    QVERIFY(p0 == p1);
+}
+
+void tst_qpromise_progress::future()
+{
+    QFutureInterface<int> iface;
+    iface.reportStarted();
+    iface.setProgressRange(0, 100);
+
+    QVector<int> values;
+    int maximum = -1;
+
+    auto p = QtPromise::resolve(iface.future()).progress([&](int value, int max) {
+        values << value;
+        maximum = max;
+    });
+
+    iface.setProgressValue(50);
+    QTRY_COMPARE(values, (QVector<int>{50}));
+    QCOMPARE(maximum, 100);
+
+    iface.reportResult(42);
+    iface.reportFinished();
+    QCOMPARE(waitForValue(p, -1), 42);
+}
@@ -10,7 +10,10 @@
 #include <QtPromise>
 #include <QtTest>
 
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <thread>
 
 class tst_qpromise_then : public QObject
 {
@@ -27,6 +30,12 @@ private Q_SLOTS:
     void stdFunctionHandlers();
     void stdBindHandlers();
     void lambdaHandlers();
+    void contextFulfilled();
+    void contextRejected();
+    void contextThread();
+    void contextDestroyed();
+    void contextDestroyedAfterSettled();
+    void contextCancel();
 };
 
 QTEST_MAIN(tst_qpromise_then)
@@ -317,3 +326,133 @@ void tst_qpromise_then::lambdaHandlers()
         QCOMPARE(waitForValue(p2, kFail), kRes);
     }
 }
+
+void tst_qpromise_then::contextFulfilled()
+{
+    QObject context;
+    QThread* target = nullptr;
+
+    auto p = QtPromise::resolve(42).then(&context, [&](int value) {
+        target = QThread::currentThread();
+        return QString::number(value);
+    });
+
+    Q_STATIC_ASSERT((std::is_same<decltype(p), QtPromise::QPromise<QString>>::value));
+
+    QCOMPARE(waitForValue(p, QString{}), QString{"42"});
+    QCOMPARE(target, context.thread());
+}
+
+void tst_qpromise_then::contextRejected()
+{
+    // Any QObject subclass can be used as context.
+    auto p = QtPromise::QPromise<int>::reject(QString{"foo"})
+                 .then(
+                     this,
+                     [](int value) {
+                         return value;
+                     },
+                     [](const QString& error) {
+                         return static_cast<int>(error.size());
+                     });
+
+    QCOMPARE(waitForValue(p, -1), 3);
+}
+
+void tst_qpromise_then::contextThread()
+{
+    QObject* context = nullptr;
+    std::atomic<bool> created{false};
+    std::atomic<bool> done{false};
+    std::thread::id target;
+
+    // The context lives in a thread without event loop, which runs its pending continuations.
+    std::thread thread([&]() {
+        QObject object;
+        context = &object;
+        created = true;
+        while (!done) {
+            QtPromise::runPending();
+            std::this_thread::yield();
+        }
+    });
+
+    while (!created) {
+        std::this_thread::yield();
+    }
+
+    QtPromise::resolve(42).then(context, [&](int) {
+        target = std::this_thread::get_id();
+        done = true;
+    });
+
+    const auto id = thread.get_id();
+    QTRY_COMPARE(done.load(), true);
+    thread.join();
+
+    QCOMPARE(target == id, true);
+}
+
+void tst_qpromise_then::contextDestroyed()
+{
+    QtPromise::QPromiseResolve<int>* resolver = nullptr;
+    auto context = new QObject{};
+    auto data = std::make_shared<int>(42);
+    std::weak_ptr<int> weak = data;
+    int calls = 0;
+
+    QtPromise::QPromise<int> input{[&](const QtPromise::QPromiseResolve<int>& resolve) {
+        resolver = new QtPromise::QPromiseResolve<int>{resolve};
+    }};
+
+    auto output = input.then(context, [&, data](int) {
+        ++calls;
+    });
+
+    data.reset();
+    QCOMPARE(weak.expired(), false);
+
+    // The continuation is detached (and its captures released) as soon as the context is
+    // destroyed, so it's not called once the input is resolved.
+    delete context;
+    QCOMPARE(weak.expired(), true);
+
+    (*resolver)(42);
+    delete resolver;
+
+    QCOMPARE(waitForValue(input, -1), 42);
+    QTest::qWait(50);
+    QCOMPARE(calls, 0);
+    QCOMPARE(output.isPending(), true);
+}
+
+void tst_qpromise_then::contextDestroyedAfterSettled()
+{
+    auto context = new QObject{};
+    int calls = 0;
+
+    auto p = QtPromise::resolve(42).then(context, [&](int) {
+        ++calls;
+    });
+
+    // Already scheduled, but dropped since the context is destroyed before it's called.
+    delete context;
+    QTest::qWait(50);
+    QCOMPARE(calls, 0);
+    QCOMPARE(p.isPending(), true);
+}
+
+void tst_qpromise_then::contextCancel()
+{
+    QFutureInterface<int> iface;
+    iface.reportStarted();
+
+    auto context = new QObject{};
+    auto input = QtPromise::resolve(iface.future());
+    input.then(context, [](int) {});
+
+    // Nobody else observes the input, so the work producing its value is canceled.
+    QCOMPARE(iface.isCanceled(), false);
+    delete context;
+    QCOMPARE(iface.isCanceled(), true);
+}
@@ -11,6 +11,7 @@
 #include <QtTest>
 
 #include <chrono>
+#include <memory>
 
 class tst_qpromise_timeout : public QObject
 {
@@ -20,6 +21,7 @@ private Q_SLOTS:
     void fulfilled();
     void rejected();
     void timeout();
+    void timerReleased();
 
     void fulfilledStdChrono();
     void rejectedStdChrono();
@@ -105,6 +107,20 @@ void tst_qpromise_timeout::timeout()
     QVERIFY(elapsed <= static_cast<qint64>(2000 * 1.06));
 }
 
+void tst_qpromise_timeout::timerReleased()
+{
+    auto error = std::make_shared<int>(42);
+    auto p = QtPromise::resolve(43).delay(10).timeout(2000, error);
+
+    QVERIFY(error.use_count() > 1);
+    QCOMPARE(waitForValue(p, -1), 43);
+    QCOMPARE(p.isFulfilled(), true);
+
+    // The pending timer (and thus the captured error) is released as soon as the
+    // input promise is settled, not when the timeout expires.
+    QCOMPARE(error.use_count(), 1L);
+}
+
 void tst_qpromise_timeout::fulfilledStdChrono()
 {
     QElapsedTimer timer;
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+#include <chrono>
+#include <thread>
+
+class tst_qpromise_tofuture : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void fulfilled();
+    void fulfilled_void();
+    void pending();
+    void rejected();
+    void rejected_void();
+    void canceledException();
+    void settledFromThread();
+    void cancel();
+};
+
+QTEST_MAIN(tst_qpromise_tofuture)
+#include "tst_tofuture.moc"
+
+void tst_qpromise_tofuture::fulfilled()
+{
+    QFuture<int> f = QtPromise::resolve(42).toFuture();
+
+    QCOMPARE(f.isFinished(), true);
+    QCOMPARE(f.isCanceled(), false);
+    QCOMPARE(f.result(), 42);
+}
+
+void tst_qpromise_tofuture::fulfilled_void()
+{
+    QFuture<void> f = QtPromise::resolve().toFuture();
+
+    QCOMPARE(f.isFinished(), true);
+    QCOMPARE(f.isCanceled(), false);
+}
+
+void tst_qpromise_tofuture::pending()
+{
+    auto p = QtPromise::resolve(42).delay(50);
+    auto f = p.toFuture();
+
+    QCOMPARE(f.isFinished(), false);
+
+    p.wait();
+
+    // Filled when the promise is settled, without waiting for the event loop.
+    QCOMPARE(f.isFinished(), true);
+    QCOMPARE(f.result(), 42);
+}
+
+void tst_qpromise_tofuture::rejected()
+{
+    QString error;
+    auto f = QtPromise::QPromise<int>::reject(QString{"foo"}).toFuture();
+
+    QCOMPARE(f.isFinished(), true);
+
+    try {
+        f.waitForFinished();
+    } catch (const QString& e) {
+        error = e;
+    }
+
+    QCOMPARE(error, QString{"foo"});
+}
+
+void tst_qpromise_tofuture::rejected_void()
+{
+    QString error;
+    auto f = QtPromise::QPromise<void>::reject(QString{"foo"}).toFuture();
+
+    QCOMPARE(f.isFinished(), true);
+
+    try {
+        f.waitForFinished();
+    } catch (const QString& e) {
+        error = e;
+    }
+
+    QCOMPARE(error, QString{"foo"});
+}
+
+void tst_qpromise_tofuture::canceledException()
+{
+    auto f = QtPromise::QPromise<int>::reject(QtPromise::QPromiseCanceledException{}).toFuture();
+
+    QCOMPARE(f.isFinished(), true);
+    QCOMPARE(f.isCanceled(), true);
+}
+
+void tst_qpromise_tofuture::settledFromThread()
+{
+    std::thread thread;
+    auto p = QtPromise::QPromise<int>{[&](const QtPromise::QPromiseResolve<int>& resolve) {
+        thread = std::thread{[=]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds{50});
+            resolve(42);
+        }};
+    }};
+
+    // The future is filled from the thread resolving the promise, so it's safe to block
+    // the current thread (and its event loop) while waiting for it.
+    auto f = p.toFuture();
+    QCOMPARE(f.result(), 42);
+
+    thread.join();
+}
+
+void tst_qpromise_tofuture::cancel()
+{
+    QFutureInterface<int> source;
+    source.reportStarted();
+
+    auto p = QtPromise::resolve(source.future());
+    auto f = p.toFuture();
+
+    // Canceling the future cancels the work of the promise nobody else is interested in.
+    f.cancel();
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!source.isCanceled() && timer.elapsed() < 5000) {
+        QCoreApplication::processEvents();
+    }
+
+    QCOMPARE(source.isCanceled(), true);
+    QCOMPARE(f.isFinished(), true);
+
+    source.reportFinished();
+
+    QCOMPARE(waitForRejected<QtPromise::QPromiseCanceledException>(p), true);
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+#include <chrono>
+#include <thread>
+
+class tst_qpromise_wait : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void wait();
+    void waitForFulfilled();
+    void waitForRejected();
+    void waitForTimeout();
+    void waitDeadline();
+    void settledFromThread();
+    void noEventLoop();
+    void waitForStdChrono();
+    void waitForLongDuration();
+};
+
+QTEST_MAIN(tst_qpromise_wait)
+#include "tst_wait.moc"
+
+void tst_qpromise_wait::wait()
+{
+    auto p = QtPromise::resolve(42).delay(50);
+
+    QCOMPARE(p.wait().isFulfilled(), true);
+    QCOMPARE(waitForValue(p, -1), 42);
+}
+
+void tst_qpromise_wait::waitForFulfilled()
+{
+    auto p0 = QtPromise::resolve(42).delay(50);
+    auto p1 = QtPromise::resolve().delay(50);
+
+    QCOMPARE(p0.waitFor(1000), QtPromise::WaitStatus::Fulfilled);
+    QCOMPARE(p1.waitFor(1000), QtPromise::WaitStatus::Fulfilled);
+    QCOMPARE(p0.waitFor(0), QtPromise::WaitStatus::Fulfilled);
+}
+
+void tst_qpromise_wait::waitForRejected()
+{
+    auto p0 = QtPromise::QPromise<int>::reject(QString{"foo"}).delay(50);
+    auto p1 = QtPromise::resolve().delay(50).then([]() {
+        throw QString{"bar"};
+    });
+
+    QCOMPARE(p0.waitFor(1000), QtPromise::WaitStatus::Rejected);
+    QCOMPARE(p1.waitFor(1000), QtPromise::WaitStatus::Rejected);
+}
+
+void tst_qpromise_wait::waitForTimeout()
+{
+    QElapsedTimer timer;
+    auto p = QtPromise::resolve(42).delay(1000);
+
+    timer.start();
+
+    QCOMPARE(p.waitFor(100), QtPromise::WaitStatus::Timeout);
+    QCOMPARE(p.isPending(), true);
+    QVERIFY(timer.elapsed() >= 100);
+    QVERIFY(timer.elapsed() < 500);
+
+    // Events of the current thread are processed while waiting.
+    QCOMPARE(p.waitFor(2000), QtPromise::WaitStatus::Fulfilled);
+}
+
+void tst_qpromise_wait::waitDeadline()
+{
+    auto p = QtPromise::resolve(42).delay(1000);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds{100};
+
+    QCOMPARE(p.wait(deadline), QtPromise::WaitStatus::Timeout);
+    QVERIFY(std::chrono::steady_clock::now() >= deadline);
+
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds{2};
+    QCOMPARE(p.wait(deadline), QtPromise::WaitStatus::Fulfilled);
+}
+
+void tst_qpromise_wait::settledFromThread()
+{
+    QElapsedTimer timer;
+    std::thread thread;
+
+    auto p = QtPromise::QPromise<int>{[&](const QtPromise::QPromiseResolve<int>& resolve) {
+        thread = std::thread{[=]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            resolve(42);
+        }};
+    }};
+
+    timer.start();
+
+    QCOMPARE(p.waitFor(5000), QtPromise::WaitStatus::Fulfilled);
+    QVERIFY(timer.elapsed() < 1000);
+
+    thread.join();
+}
+
+void tst_qpromise_wait::noEventLoop()
+{
+    QtPromise::WaitStatus status = QtPromise::WaitStatus::Timeout;
+
+    auto p = QtPromise::resolve(42).delay(100);
+
+    // Threads without event loop block on a condition variable.
+    std::thread thread{[&]() {
+        status = p.waitFor(5000);
+    }};
+
+    QCOMPARE(waitForValue(p, -1), 42);
+
+    thread.join();
+
+    QCOMPARE(status, QtPromise::WaitStatus::Fulfilled);
+}
+
+void tst_qpromise_wait::waitForStdChrono()
+{
+    auto p = QtPromise::resolve(42).delay(1000);
+
+    QCOMPARE(p.waitFor(std::chrono::milliseconds{50}), QtPromise::WaitStatus::Timeout);
+    QCOMPARE(p.waitFor(std::chrono::seconds{2}), QtPromise::WaitStatus::Fulfilled);
+}
+
+void tst_qpromise_wait::waitForLongDuration()
+{
+    auto p = QtPromise::resolve(42).delay(50);
+
+    // Durations which don't fit in an int (~24.8 days) must not time out immediately.
+    QCOMPARE(p.waitFor(std::chrono::hours{24 * 30}), QtPromise::WaitStatus::Fulfilled);
+
+    p = QtPromise::resolve(42).delay(50);
+    QCOMPARE(p.waitFor(std::chrono::milliseconds::max()), QtPromise::WaitStatus::Fulfilled);
+
+    p = QtPromise::resolve(42).delay(50);
+    QCOMPARE(p.waitFor(std::chrono::milliseconds{-1}), QtPromise::WaitStatus::Timeout);
+}
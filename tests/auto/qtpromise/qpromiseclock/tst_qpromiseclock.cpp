@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+#include <chrono>
+
+class tst_qpromiseclock : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void install();
+    void timeout();
+    void delay();
+    void ordering();
+    void nested();
+    void every();
+    void hedge();
+    void restore();
+    void stdChrono();
+
+}; // class tst_qpromiseclock
+
+QTEST_MAIN(tst_qpromiseclock)
+#include "tst_qpromiseclock.moc"
+
+namespace {
+
+template<typename T>
+QtPromise::QPromise<T> pending()
+{
+    return QtPromise::QPromise<T>{[](const QtPromise::QPromiseResolve<T>&) {}};
+}
+
+} // anonymous namespace
+
+void tst_qpromiseclock::install()
+{
+    QVERIFY(QtPromise::QPromiseClock::current() == nullptr);
+
+    {
+        QtPromise::QPromiseVirtualClock clock;
+        QVERIFY(QtPromise::QPromiseClock::current() == &clock);
+        QCOMPARE(clock.now(), 0LL);
+
+        {
+            QtPromise::QPromiseVirtualClock nested;
+            QVERIFY(QtPromise::QPromiseClock::current() == &nested);
+        }
+
+        QVERIFY(QtPromise::QPromiseClock::current() == &clock);
+
+        clock.advance(42);
+        QCOMPARE(clock.now(), 42LL);
+    }
+
+    QVERIFY(QtPromise::QPromiseClock::current() == nullptr);
+}
+
+void tst_qpromiseclock::timeout()
+{
+    QtPromise::QPromiseVirtualClock clock;
+
+    auto p = pending<int>().timeout(2000);
+
+    clock.advance(1999);
+    QCOMPARE(p.isPending(), true);
+
+    clock.advance(1);
+    QCOMPARE(p.isRejected(), true);
+    QCOMPARE(waitForRejected<QtPromise::QPromiseTimeoutException>(p), true);
+}
+
+void tst_qpromiseclock::delay()
+{
+    QtPromise::QPromiseVirtualClock clock;
+
+    auto p0 = QtPromise::resolve(42).delay(1000);
+    auto p1 = QtPromise::resolve().delay(60000);
+
+    clock.advance(999);
+    QCOMPARE(p0.isPending(), true);
+
+    clock.advance(1);
+    QCOMPARE(p0.isFulfilled(), true);
+    QCOMPARE(waitForValue(p0, -1), 42);
+
+    clock.advance(59000);
+    QCOMPARE(p1.isFulfilled(), true);
+}
+
+void tst_qpromiseclock::ordering()
+{
+    QtPromise::QPromiseVirtualClock clock;
+    QVector<QtPromise::QPromise<int>> promises;
+    QVector<int> values;
+
+    // Thousands of timers, spread across all levels of the timer wheel.
+    for (int i = 0; i < 5000; ++i) {
+        const int msec = (i * 7919) % 500000;
+        promises << QtPromise::resolve(msec).delay(msec).tap([&](int value) {
+            values << value;
+        });
+    }
+
+    clock.advance(500000);
+
+    QtPromise::all(promises).wait();
+
+    QCOMPARE(values.size(), 5000);
+    QVERIFY(std::is_sorted(values.begin(), values.end()));
+}
+
+void tst_qpromiseclock::nested()
+{
+    QtPromise::QPromiseVirtualClock clock;
+    QVector<qint64> times;
+
+    // Timers started while expiring other timers are expired in the same advance() call.
+    auto p = QtPromise::resolve(42).delay(100).then([&](int value) {
+        times << clock.now();
+        return QtPromise::resolve(value).delay(100);
+    });
+
+    clock.advance(100);
+    QCoreApplication::processEvents();
+    QCOMPARE(times, QVector<qint64>{100});
+    QCOMPARE(p.isPending(), true);
+
+    clock.advance(100);
+    QCOMPARE(waitForValue(p, -1), 42);
+}
+
+void tst_qpromiseclock::every()
+{
+    QtPromise::QPromiseVirtualClock clock;
+
+    auto ticker = QtPromise::every(100);
+    auto p = ticker.next();
+
+    clock.advance(100);
+    QCOMPARE(p.isFulfilled(), true);
+    QCOMPARE(waitForValue(p, -1), 1);
+
+    clock.advance(350);
+    QCOMPARE(waitForValue(ticker.next(), -1), 3);
+}
+
+void tst_qpromiseclock::hedge()
+{
+    QtPromise::QPromiseVirtualClock clock;
+    int calls = 0;
+
+    auto p = QtPromise::hedge(
+        [&]() {
+            ++calls;
+            return pending<int>();
+        },
+        200,
+        3);
+
+    QCOMPARE(calls, 1);
+
+    clock.advance(200);
+    QCOMPARE(calls, 2);
+
+    clock.advance(10000);
+    QCOMPARE(calls, 3);
+    QCOMPARE(p.isPending(), true);
+}
+
+void tst_qpromiseclock::restore()
+{
+    QElapsedTimer timer;
+    QtPromise::QPromise<int> p = QtPromise::resolve(-1);
+
+    {
+        QtPromise::QPromiseVirtualClock clock;
+        p = QtPromise::resolve(42).delay(1000);
+        clock.advance(900);
+    }
+
+    // Pending timers keep their remaining time on the restored (system) clock.
+    timer.start();
+
+    QCOMPARE(p.isPending(), true);
+    QCOMPARE(waitForValue(p, -1), 42);
+    QVERIFY(timer.elapsed() >= 90);
+    QVERIFY(timer.elapsed() < 500);
+}
+
+void tst_qpromiseclock::stdChrono()
+{
+    QtPromise::QPromiseVirtualClock clock;
+
+    auto p = pending<void>().timeout(std::chrono::seconds{2});
+
+    clock.advance(std::chrono::seconds{2});
+    QCOMPARE(p.isRejected(), true);
+}
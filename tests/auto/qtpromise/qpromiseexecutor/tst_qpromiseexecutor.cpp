@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtConcurrent>
+#include <QtPromise>
+#include <QtTest>
+
+#include <atomic>
+#include <thread>
+
+using namespace QtPromise;
+
+class tst_qpromiseexecutor : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void null();
+    void immediate();
+    void thread();
+    void context();
+    void contextDestroyed();
+    void contextMoved();
+    void pool();
+    void poolDestroyed();
+    void functor();
+    void functorDropped();
+    void thenRejected();
+    void via();
+    void viaOverride();
+
+}; // class tst_qpromiseexecutor
+
+QTEST_MAIN(tst_qpromiseexecutor)
+#include "tst_qpromiseexecutor.moc"
+
+void tst_qpromiseexecutor::null()
+{
+    QThread* target = nullptr;
+    QPromiseExecutor executor;
+    QCOMPARE(executor.isNull(), true);
+
+    // A null executor behaves like then(fn): called in the current thread.
+    auto p = QtPromise::resolve(42).then(executor, [&](int value) {
+        target = QThread::currentThread();
+        return value + 1;
+    });
+
+    QCOMPARE(waitForValue(p, -1), 43);
+    QCOMPARE(target, QThread::currentThread());
+}
+
+void tst_qpromiseexecutor::immediate()
+{
+    std::function<void(int)> resolver;
+    std::thread::id target;
+
+    auto p = QPromise<int>{[&](const QPromiseResolve<int>& resolve) {
+                 resolver = resolve;
+             }}
+                 .then(QPromiseExecutor::immediate(), [&](int value) {
+                     target = std::this_thread::get_id();
+                     return value + 1;
+                 });
+
+    // Called synchronously by the settling thread.
+    std::thread source([&]() {
+        resolver(42);
+    });
+
+    const auto id = source.get_id();
+    source.join();
+
+    QCOMPARE(target == id, true);
+    QCOMPARE(waitForValue(p, -1), 43);
+}
+
+void tst_qpromiseexecutor::thread()
+{
+    QThread* main = QThread::currentThread();
+    QThread* source = nullptr;
+    std::atomic<QThread*> target{nullptr};
+
+    // Continuation registered from a worker thread but called in the main thread.
+    QtConcurrent::run([&]() {
+        source = QThread::currentThread();
+        QtPromise::resolve(42).then(QPromiseExecutor::thread(main), [&](int) {
+            target = QThread::currentThread();
+        });
+    }).waitForFinished();
+
+    QTRY_COMPARE(target.load(), main);
+    QVERIFY(source != main);
+}
+
+void tst_qpromiseexecutor::context()
+{
+    QObject context;
+    QThread* target = nullptr;
+
+    auto p = QtPromise::resolve(42).then(QPromiseExecutor::context(&context), [&](int value) {
+        target = QThread::currentThread();
+        return value + 1;
+    });
+
+    QCOMPARE(waitForValue(p, -1), 43);
+    QCOMPARE(target, context.thread());
+}
+
+void tst_qpromiseexecutor::contextDestroyed()
+{
+    auto context = new QObject{};
+    int calls = 0;
+
+    auto p = QtPromise::resolve(42).then(QPromiseExecutor::context(context), [&](int) {
+        ++calls;
+    });
+
+    // The continuation is dropped, so the output promise is never settled.
+    delete context;
+    QTest::qWait(50);
+    QCOMPARE(calls, 0);
+    QCOMPARE(p.isPending(), true);
+}
+
+void tst_qpromiseexecutor::contextMoved()
+{
+    QThread thread;
+    auto context = new QObject{};
+    int calls = 0;
+
+    // The continuation is posted to the thread of `context` when the executor is created, which
+    // is never accessed from the settling thread: it's dropped once `context` has moved.
+    auto p = QtPromise::resolve(42).then(QPromiseExecutor::context(context), [&](int) {
+        ++calls;
+    });
+
+    // `thread` doesn't need to run: the continuation is dropped in the main thread.
+    context->moveToThread(&thread);
+
+    QTest::qWait(50);
+    QCOMPARE(calls, 0);
+    QCOMPARE(p.isPending(), true);
+
+    delete context;
+}
+
+void tst_qpromiseexecutor::pool()
+{
+    QThreadPool pool;
+    QThread* target = nullptr;
+    QThread* next = nullptr;
+
+    auto p = QtPromise::resolve(42)
+                 .then(QPromiseExecutor::pool(&pool),
+                       [&](int value) {
+                           target = QThread::currentThread();
+                           return value + 1;
+                       })
+                 .then([&](int value) {
+                     next = QThread::currentThread();
+                     return value + 1;
+                 });
+
+    QCOMPARE(waitForValue(p, -1), 44);
+    QVERIFY(target != nullptr);
+    QVERIFY(target != QThread::currentThread());
+
+    // Back to the thread which registered the next continuation.
+    QCOMPARE(next, QThread::currentThread());
+}
+
+void tst_qpromiseexecutor::poolDestroyed()
+{
+    auto pool = new QThreadPool{};
+    auto executor = QPromiseExecutor::pool(pool);
+    delete pool;
+
+    // The continuation can't be started, so the output promise is rejected.
+    auto p = QtPromise::resolve(42).then(executor, [](int value) {
+        return value + 1;
+    });
+
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p), true);
+}
+
+void tst_qpromiseexecutor::functor()
+{
+    int calls = 0;
+    QPromiseExecutor executor{[&](std::function<void()> fn) {
+        ++calls;
+        QtPromisePrivate::qtpromise_defer(std::move(fn));
+    }};
+
+    auto p = QtPromise::resolve(42)
+                 .then(executor,
+                       [](int value) {
+                           return value + 1;
+                       })
+                 .then(executor, [](int value) {
+                     return value + 1;
+                 });
+
+    QCOMPARE(waitForValue(p, -1), 44);
+    QCOMPARE(calls, 2);
+}
+
+void tst_qpromiseexecutor::functorDropped()
+{
+    int calls = 0;
+    QPromiseExecutor executor{[](std::function<void()>) {
+        return false;
+    }};
+
+    auto p = QtPromise::resolve(42)
+                 .via(executor)
+                 .then([&](int value) {
+                     ++calls;
+                     return value + 1;
+                 })
+                 .then(
+                     [](int value) {
+                         return value + 1;
+                     },
+                     [](const QPromiseCanceledException&) {
+                         return -1;
+                     });
+
+    // Reported as dropped, the first continuation rejects its output instead of being called.
+    QCOMPARE(waitForValue(p, 0), -1);
+    QCOMPARE(calls, 0);
+}
+
+void tst_qpromiseexecutor::thenRejected()
+{
+    QThreadPool pool;
+    QThread* target = nullptr;
+
+    auto p = QPromise<int>::reject(QString{"foo"})
+                 .then(
+                     QPromiseExecutor::pool(&pool),
+                     [](int value) {
+                         return value;
+                     },
+                     [&](const QString& error) {
+                         target = QThread::currentThread();
+                         return static_cast<int>(error.size());
+                     });
+
+    QCOMPARE(waitForValue(p, -1), 3);
+    QVERIFY(target != nullptr);
+    QVERIFY(target != QThread::currentThread());
+}
+
+void tst_qpromiseexecutor::via()
+{
+    int calls = 0;
+    QVector<int> values;
+    QPromiseExecutor executor{[&](std::function<void()> fn) {
+        ++calls;
+        QtPromisePrivate::qtpromise_defer(std::move(fn));
+    }};
+
+    auto p0 = QtPromise::resolve(42).via(executor);
+    Q_STATIC_ASSERT((std::is_same<decltype(p0), QPromise<int>>::value));
+
+    // The continuations of the returned promise are called through the executor.
+    auto p1 = p0.then([&](int value) {
+        values << value;
+    });
+    auto p2 = p0.tap([&](int value) {
+        values << value;
+    });
+
+    QCOMPARE(waitForValue(p0, -1), 42);
+    QCOMPARE(waitForValue(p1, -1, 42), 42);
+    QCOMPARE(waitForValue(p2, -1), 42);
+    QCOMPARE(values, (QVector<int>{42, 42}));
+    QVERIFY(calls >= 2);
+}
+
+void tst_qpromiseexecutor::viaOverride()
+{
+    QThreadPool pool;
+    QThread* target = nullptr;
+    int calls = 0;
+
+    QPromiseExecutor executor{[&](std::function<void()> fn) {
+        ++calls;
+        QtPromisePrivate::qtpromise_defer(std::move(fn));
+    }};
+
+    // An explicit executor takes precedence over the one given to via().
+    auto p = QtPromise::resolve(42).via(executor).then(QPromiseExecutor::pool(&pool),
+                                                        [&](int value) {
+                                                            target = QThread::currentThread();
+                                                            return value;
+                                                        });
+
+    QCOMPARE(waitForValue(p, -1), 42);
+    QVERIFY(target != QThread::currentThread());
+}
@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) Simon Brunel, https://github.com/simonbrunel
+ *
+ * This source code is licensed under the MIT license found in
+ * the LICENSE file in the root directory of this source tree.
+ */
+
+#include "../shared/utils.h"
+
+#include <QtPromise>
+#include <QtTest>
+
+#include <atomic>
+#include <thread>
+
+using namespace QtPromise;
+
+class tst_qpromisethreadpool : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void threadCount();
+    void start();
+    void locality();
+    void steal();
+    void queueDepth();
+    void destroy();
+    void destroyFromTask();
+    void executor();
+    void executorDestroyed();
+    void executorStopping();
+    void continuation();
+    void timer();
+
+}; // class tst_qpromisethreadpool
+
+QTEST_MAIN(tst_qpromisethreadpool)
+#include "tst_qpromisethreadpool.moc"
+
+void tst_qpromisethreadpool::threadCount()
+{
+    QCOMPARE(QPromiseThreadPool{3}.threadCount(), 3);
+    QCOMPARE(QPromiseThreadPool{0}.threadCount(), 1);
+    QVERIFY(QPromiseThreadPool{}.threadCount() >= 1);
+}
+
+void tst_qpromisethreadpool::start()
+{
+    QThread* main = QThread::currentThread();
+    std::atomic<int> calls{0};
+    std::atomic<bool> local{false};
+    QPromiseThreadPool pool{4};
+
+    for (int i = 0; i < 100; ++i) {
+        pool.start([&]() {
+            if (QThread::currentThread() == main) {
+                local = true;
+            }
+            ++calls;
+        });
+    }
+
+    QTRY_COMPARE(calls.load(), 100);
+    QCOMPARE(local.load(), false);
+    QCOMPARE(pool.queueDepth(), 0);
+}
+
+void tst_qpromisethreadpool::locality()
+{
+    std::atomic<bool> blocking{false};
+    std::atomic<bool> release{false};
+    std::atomic<bool> done{false};
+    std::thread::id parent;
+    std::thread::id child;
+    QPromiseThreadPool pool{2};
+
+    // Keep the other worker busy so that it can't steal the child task.
+    pool.start([&]() {
+        blocking = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+
+    QTRY_COMPARE(blocking.load(), true);
+
+    pool.start([&]() {
+        parent = std::this_thread::get_id();
+        pool.start([&]() {
+            child = std::this_thread::get_id();
+            done = true;
+        });
+    });
+
+    QTRY_COMPARE(done.load(), true);
+    release = true;
+
+    QCOMPARE(child == parent, true);
+    QCOMPARE(pool.stealCount(), qint64(0));
+}
+
+void tst_qpromisethreadpool::steal()
+{
+    std::atomic<int> calls{0};
+    std::atomic<bool> stolen{true};
+    std::thread::id parent;
+    QPromiseThreadPool pool{2};
+
+    // The parent blocks until its children have been run, so by the other worker.
+    pool.start([&]() {
+        parent = std::this_thread::get_id();
+        for (int i = 0; i < 2; ++i) {
+            pool.start([&]() {
+                if (std::this_thread::get_id() == parent) {
+                    stolen = false;
+                }
+                ++calls;
+            });
+        }
+
+        while (calls < 2) {
+            std::this_thread::yield();
+        }
+    });
+
+    QTRY_COMPARE(calls.load(), 2);
+    QCOMPARE(stolen.load(), true);
+    QCOMPARE(pool.stealCount(), qint64(2));
+}
+
+void tst_qpromisethreadpool::queueDepth()
+{
+    std::atomic<bool> blocking{false};
+    std::atomic<bool> release{false};
+    std::atomic<int> calls{0};
+    QPromiseThreadPool pool{1};
+
+    pool.start([&]() {
+        blocking = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+
+    QTRY_COMPARE(blocking.load(), true);
+
+    for (int i = 0; i < 3; ++i) {
+        pool.start([&]() {
+            ++calls;
+        });
+    }
+
+    // Tasks started from outside the pool are queued to the shared queue.
+    QCOMPARE(pool.queueDepth(), 3);
+    QCOMPARE(pool.queueDepth(0), 0);
+    QCOMPARE(pool.queueDepth(1), 0);
+
+    release = true;
+
+    QTRY_COMPARE(calls.load(), 3);
+    QCOMPARE(pool.queueDepth(), 0);
+}
+
+void tst_qpromisethreadpool::destroy()
+{
+    std::atomic<int> calls{0};
+
+    {
+        QPromiseThreadPool pool{2};
+        for (int i = 0; i < 10; ++i) {
+            pool.start([&]() {
+                QThread::msleep(1);
+                ++calls;
+            });
+        }
+    }
+
+    // The remaining tasks are run before the workers are joined.
+    QCOMPARE(calls.load(), 10);
+}
+
+void tst_qpromisethreadpool::destroyFromTask()
+{
+    auto pool = new QPromiseThreadPool{2};
+    std::atomic<int> calls{0};
+    std::atomic<bool> destroyed{false};
+
+    // The worker destroying the pool can't join itself: it's detached instead and runs the
+    // remaining tasks (including the ones started after that) once this one returns.
+    pool->start([&]() {
+        for (int i = 0; i < 10; ++i) {
+            pool->start([&]() {
+                ++calls;
+            });
+        }
+
+        QtPromise::resolve(42).then([&]() {
+            ++calls;
+        });
+
+        delete pool;
+        destroyed = true;
+    });
+
+    QTRY_VERIFY(destroyed.load());
+    QTRY_COMPARE(calls.load(), 11);
+}
+
+void tst_qpromisethreadpool::executor()
+{
+    QPromiseThreadPool pool{2};
+    std::atomic<QThread*> target{nullptr};
+
+    auto p = QtPromise::resolve(42)
+                 .then(pool.executor(),
+                       [&](int value) {
+                           target = QThread::currentThread();
+                           return value + 1;
+                       })
+                 .then([](int value) {
+                     return value + 1;
+                 });
+
+    QCOMPARE(waitForValue(p, -1), 44);
+    QVERIFY(target.load() != nullptr);
+    QVERIFY(target.load() != QThread::currentThread());
+}
+
+void tst_qpromisethreadpool::executorDestroyed()
+{
+    int calls = 0;
+    QPromiseExecutor executor = QPromiseThreadPool{1}.executor();
+
+    // The continuation can't be started, so the output promise is rejected.
+    auto p = QtPromise::resolve(42).then(executor, [&](int) {
+        ++calls;
+    });
+
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p), true);
+    QCOMPARE(calls, 0);
+}
+
+void tst_qpromisethreadpool::executorStopping()
+{
+    auto pool = new QPromiseThreadPool{1};
+    QPromiseExecutor executor = pool->executor();
+    std::atomic<bool> blocking{false};
+    std::atomic<bool> release{false};
+    std::atomic<int> calls{0};
+    int accepted = 0;
+
+    pool->start([&]() {
+        blocking = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+
+    QTRY_COMPARE(blocking.load(), true);
+    std::thread destroyer{[&]() {
+        delete pool;
+    }};
+
+    // Tasks are accepted until the pool starts shutting down, then rejected.
+    while (executor.execute([&]() {
+        ++calls;
+    })) {
+        ++accepted;
+        std::this_thread::yield();
+    }
+
+    auto p = QtPromise::resolve(42).then(executor, [&](int) {
+        ++calls;
+    });
+
+    QCOMPARE(waitForRejected<QPromiseCanceledException>(p), true);
+
+    release = true;
+    destroyer.join();
+
+    // None of the accepted tasks has been lost.
+    QCOMPARE(calls.load(), accepted);
+}
+
+void tst_qpromisethreadpool::continuation()
+{
+    std::atomic<bool> done{false};
+    std::thread::id source;
+    std::thread::id target;
+    QPromiseThreadPool pool{2};
+
+    // Continuations registered from a worker without executor are called by that worker.
+    pool.start([&]() {
+        source = std::this_thread::get_id();
+        QtPromise::resolve(42).then([&](int) {
+            target = std::this_thread::get_id();
+            done = true;
+        });
+    });
+
+    QTRY_COMPARE(done.load(), true);
+    QCOMPARE(target == source, true);
+}
+
+void tst_qpromisethreadpool::timer()
+{
+    std::atomic<bool> done{false};
+    std::thread::id source;
+    std::thread::id target;
+    QPromiseThreadPool pool{2};
+
+    // Timers started from an idle worker are expired by that worker.
+    pool.start([&]() {
+        source = std::this_thread::get_id();
+        QPromise<int>{[](const QPromiseResolve<int>&) { }}.timeout(50).fail(
+            [&](const QPromiseTimeoutException&) {
+                target = std::this_thread::get_id();
+                done = true;
+                return -1;
+            });
+    });
+
+    QTRY_COMPARE(done.load(), true);
+    QCOMPARE(target == source, true);
+}
@@ -17,10 +17,20 @@ class Object : public QObject
 public:
     bool hasConnections() const { return m_connections > 0; }
 
+    void emitPrivateNoArgSignal() { Q_EMIT privateNoArgSignal(QPrivateSignal{}); }
+    void emitPrivateOneArgSignal(const QString& v) { Q_EMIT privateOneArgSignal(v, QPrivateSignal{}); }
+    void emitPrivateTwoArgsSignal(int v0, const QString& v1)
+    {
+        Q_EMIT privateTwoArgsSignal(v0, v1, QPrivateSignal{});
+    }
+
 Q_SIGNALS:
     void noArgSignal();
     void oneArgSignal(const QString& v);
     void twoArgsSignal(int v1, const QString& v0);
+    void privateNoArgSignal(QPrivateSignal);
+    void privateOneArgSignal(const QString& v, QPrivateSignal);
+    void privateTwoArgsSignal(int v0, const QString& v1, QPrivateSignal);
 
 protected:
     int m_connections = 0;
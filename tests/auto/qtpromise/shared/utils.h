@@ -10,6 +10,8 @@
 
 #include <QtPromise>
 
+#include <QtCore/QTimer>
+
 template<typename T>
 static inline T waitForValue(const QtPromise::QPromise<T>& promise, const T& initial)
 {
@@ -72,4 +74,15 @@ static inline bool waitForRejected(const T& promise)
     return result;
 }
 
+template<typename T>
+static inline QtPromise::QPromise<T> rejectLater(int msec, const QString& error)
+{
+    return QtPromise::QPromise<T>{
+        [=](const QtPromise::QPromiseResolve<T>&, const QtPromise::QPromiseReject<T>& reject) {
+            QTimer::singleShot(msec, [=]() {
+                reject(error);
+            });
+        }};
+}
+
 #endif // QTPROMISE_TESTS_AUTO_SHARED_UTILS_H
@@ -9,6 +9,9 @@
 #include <QtPromise>
 #include <QtTest>
 
+#include <atomic>
+#include <thread>
+
 class tst_thread : public QObject
 {
     Q_OBJECT
@@ -21,6 +24,9 @@ private Q_SLOTS:
     void then_void();
     void fail();
     void finally();
+    void noEventLoop_wait();
+    void noEventLoop_runPending();
+    void noEventLoop_pipeline();
 
 }; // class tst_thread
 
@@ -206,3 +212,109 @@ void tst_thread::finally()
     QCOMPARE(source, QThread::currentThread());
     QCOMPARE(value, 43);
 }
+
+void tst_thread::noEventLoop_wait()
+{
+    QThread* source = nullptr;
+    QThread* target = nullptr;
+    int value = -1;
+
+    auto p = QtPromise::resolve(42).delay(50);
+
+    // Continuations registered from a thread without event loop are called by that thread
+    // while it's blocked waiting for a promise.
+    std::thread thread{[&]() {
+        source = QThread::currentThread();
+        p.then([&](int res) {
+             target = QThread::currentThread();
+             value = res;
+         })
+            .wait();
+    }};
+
+    p.wait();
+    thread.join();
+
+    QVERIFY(source != nullptr);
+    QVERIFY(source != QThread::currentThread());
+    QCOMPARE(target, source);
+    QCOMPARE(value, 42);
+}
+
+void tst_thread::noEventLoop_runPending()
+{
+    std::atomic<bool> done{false};
+    QThread* source = nullptr;
+    QThread* target = nullptr;
+    int calls = 0;
+
+    auto p = QtPromise::resolve(42).delay(50);
+
+    // Continuations are called by the worker's own task loop, explicitly.
+    std::thread thread{[&]() {
+        source = QThread::currentThread();
+        p.then([&](int res) {
+            target = QThread::currentThread();
+            done = res == 42;
+        });
+
+        while (!done) {
+            calls += QtPromise::runPending();
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }};
+
+    p.wait();
+    thread.join();
+
+    QCOMPARE(target, source);
+    QCOMPARE(calls, 1);
+    QCOMPARE(QtPromise::runPending(), 0);
+}
+
+void tst_thread::noEventLoop_pipeline()
+{
+    std::atomic<bool> ready{false};
+    std::thread producer;
+    QThread* source = nullptr;
+    QThread* target = nullptr;
+    int value = -1;
+
+    // Promise resolved by a thread and consumed by another one, both without event loop.
+    auto input = QtPromise::QPromise<int>{[&](const QtPromise::QPromiseResolve<int>& resolve) {
+        producer = std::thread{[&, resolve]() {
+            while (!ready) {
+                std::this_thread::yield();
+            }
+
+            source = QThread::currentThread();
+            resolve(20);
+        }};
+    }};
+
+    std::thread consumer{[&]() {
+        auto output = input
+                          .then([&](int res) {
+                              target = QThread::currentThread();
+                              return res + 1;
+                          })
+                          .then([](int res) {
+                              return res * 2;
+                          });
+
+        ready = true;
+        output.then([&](int res) {
+                  value = res;
+              })
+            .wait();
+    }};
+
+    producer.join();
+    consumer.join();
+
+    QVERIFY(source != nullptr);
+    QVERIFY(target != nullptr);
+    QVERIFY(source != target);
+    QVERIFY(target != QThread::currentThread());
+    QCOMPARE(value, 42);
+}